@@ -1,4 +1,5 @@
 #include "audio_capturer.h"
+#include "vad_segmenter.h"
 
 #include <string>
 #include <thread>
@@ -28,29 +29,7 @@ std::mutex AudioCapturer::recordMutex;
 std::vector<BYTE> AudioCapturer::fullRecordingData;
 
 namespace {
-    std::vector<BYTE> vadBuffer;
-    int silenceFrames = 0;
-    int speechFrames = 0;
-    bool inSpeech = false;
-    std::vector<BYTE> leftoverBytes;
-}
-
-float findPeakAbs(const int16_t* samples, size_t count) {
-    float peak = 0.0f;
-    for (size_t i = 0; i < count; ++i) {
-        float absVal = std::abs(samples[i] / 32768.0f);
-        if (absVal > peak) peak = absVal;
-    }
-    return peak;
-}
-
-void applyGain(int16_t* samples, size_t count, float gain) {
-    for (size_t i = 0; i < count; ++i) {
-        float v = samples[i] * gain;
-        if (v > 32767.0f) v = 32767.0f;
-        if (v < -32768.0f) v = -32768.0f;
-        samples[i] = static_cast<int16_t>(std::round(v));
-    }
+    VadSegmenter vadSegmenter;
 }
 
 void AudioCapturer::startAudioCapture(int secondsPerFile) {
@@ -58,7 +37,6 @@ void AudioCapturer::startAudioCapture(int secondsPerFile) {
     if (recording) return;
     recording = true;
     fullRecordingData.clear();
-    leftoverBytes.clear();
     captureThread = std::thread(captureLoop, secondsPerFile);
 }
 
@@ -99,33 +77,27 @@ void AudioCapturer::captureLoop(int secondsPerFile) {
     int segmentIdx = 1;
     std::string dateStr = getCurrentDateString();
 
-    vadBuffer.clear();
-    silenceFrames = 0;
-    speechFrames = 0;
-    inSpeech = false;
-    leftoverBytes.clear();
+    vadSegmenter.reset(sampleRate, channels);
+    auto onSegment = [&](std::vector<BYTE>& segment, float, size_t, size_t, size_t) {
+        saveSegmentedAudioFile(segment, pwfx, segmentIdx++, dateStr);
+        fullRecordingData.insert(fullRecordingData.end(), segment.begin(), segment.end());
+    };
 
     while (recording) {
         std::vector<BYTE> capturedBuffer;
         processAudioBuffer(pCaptureClient, pwfx->nBlockAlign, capturedBuffer);
 
         if (!capturedBuffer.empty()) {
-            leftoverBytes.insert(leftoverBytes.end(), capturedBuffer.begin(), capturedBuffer.end());
-            vadSentenceSplitter({}, pwfx, segmentIdx, dateStr);
+            vadSegmenter.push(capturedBuffer.data(), capturedBuffer.size(), onSegment);
         }
 
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
 
-    vadSentenceSplitter({}, pwfx, segmentIdx, dateStr, true);
+    vadSegmenter.flush(onSegment);
 
     if (!fullRecordingData.empty()) {
-        int16_t* samples = reinterpret_cast<int16_t*>(fullRecordingData.data());
-        size_t sampleCount = fullRecordingData.size() / sizeof(int16_t);
-        float peak = findPeakAbs(samples, sampleCount);
-        float target = 0.98f;
-        float gain = (peak > 0.0001f && peak < target) ? (target / peak) : 1.0f;
-        if (gain > 1.01f) applyGain(samples, sampleCount, gain);
+        VadSegmenter::normalizePeak(reinterpret_cast<int16_t*>(fullRecordingData.data()), fullRecordingData.size() / sizeof(int16_t));
         saveFullAudioFile(fullRecordingData, pwfx, dateStr);
     }
 
@@ -298,84 +270,4 @@ void AudioCapturer::cleanupAudioDevices(WAVEFORMATEX* pwfx, IAudioCaptureClient*
     pAudioClient->Release();
     pDevice->Release();
     pEnumerator->Release();
-}
-
-float AudioCapturer::frameRMS(const int16_t* samples, size_t count) {
-    double sum = 0.0;
-    for (size_t i = 0; i < count; ++i) {
-        double v = samples[i] / 32768.0;
-        sum += v * v;
-    }
-    return static_cast<float>(sqrt(sum / count));
-}
-
-void AudioCapturer::vadSentenceSplitter(const std::vector<BYTE>&, WAVEFORMATEX* pwfx, int& segmentIdx, const std::string& dateStr, bool forceFlush) {
-    const int sampleRate = pwfx->nSamplesPerSec;
-    const int channels = pwfx->nChannels;
-    const int bytesPerSample = 2;
-    const int frameSamples = (sampleRate * VAD_FRAME_MS) / 1000;
-    const int frameBytes = frameSamples * bytesPerSample * channels;
-    size_t offset = 0;
-
-    static int hangoverFrames = 0;
-
-    while (leftoverBytes.size() - offset >= frameBytes) {
-        const int16_t* frame = reinterpret_cast<const int16_t*>(&leftoverBytes[offset]);
-        float rms = frameRMS(frame, frameSamples * channels);
-
-        vadBuffer.insert(vadBuffer.end(), (BYTE*)frame, (BYTE*)frame + frameBytes);
-
-        if (rms > VAD_ENERGY_THRESHOLD) {
-            speechFrames++;
-            silenceFrames = 0;
-            inSpeech = true;
-            hangoverFrames = HANGOVER_MAX;
-        }
-        else {
-            if (inSpeech) silenceFrames++;
-            if (hangoverFrames > 0) {
-                hangoverFrames--;
-            }
-            if (inSpeech && silenceFrames >= VAD_MIN_SILENCE_FRAMES && speechFrames >= VAD_MIN_SPEECH_FRAMES && hangoverFrames == 0) {
-                if (!vadBuffer.empty()) {
-                    int16_t* segSamples = reinterpret_cast<int16_t*>(vadBuffer.data());
-                    size_t segCount = vadBuffer.size() / sizeof(int16_t);
-                    float peak = findPeakAbs(segSamples, segCount);
-                    float target = 0.98f;
-                    float gain = (peak > 0.0001f && peak < target) ? (target / peak) : 1.0f;
-                    if (gain > 1.01f) applyGain(segSamples, segCount, gain);
-                }
-                saveSegmentedAudioFile(vadBuffer, pwfx, segmentIdx++, dateStr);
-                fullRecordingData.insert(fullRecordingData.end(), vadBuffer.begin(), vadBuffer.end());
-
-                vadBuffer.clear();
-                silenceFrames = 0;
-                speechFrames = 0;
-                inSpeech = false;
-                hangoverFrames = 0;
-            }
-        }
-        offset += frameBytes;
-    }
-    if (offset > 0) {
-        leftoverBytes.erase(leftoverBytes.begin(), leftoverBytes.begin() + offset);
-    }
-
-    if (forceFlush && !vadBuffer.empty()) {
-        int16_t* segSamples = reinterpret_cast<int16_t*>(vadBuffer.data());
-        size_t segCount = vadBuffer.size() / sizeof(int16_t);
-        float peak = findPeakAbs(segSamples, segCount);
-        float target = 0.98f;
-        float gain = (peak > 0.0001f && peak < target) ? (target / peak) : 1.0f;
-        if (gain > 1.01f) applyGain(segSamples, segCount, gain);
-
-        saveSegmentedAudioFile(vadBuffer, pwfx, segmentIdx++, dateStr);
-        fullRecordingData.insert(fullRecordingData.end(), vadBuffer.begin(), vadBuffer.end());
-
-        vadBuffer.clear();
-        silenceFrames = 0;
-        speechFrames = 0;
-        inSpeech = false;
-        hangoverFrames = 0;
-    }
 }
\ No newline at end of file
@@ -24,14 +24,9 @@ public:
     static void stopAudioCapture();
     static bool isRecording();
 
-private:
-    static constexpr int VAD_FRAME_MS = 20;
-    static constexpr float VAD_ENERGY_THRESHOLD = 0.008f;
-
-    static constexpr int VAD_MIN_SPEECH_FRAMES = 12;  // ~240ms
-    static constexpr int VAD_MIN_SILENCE_FRAMES = 18; // ~360ms
-    static constexpr int HANGOVER_MAX = 10; // ~200ms
+    static void writeWavHeader(std::ofstream& out, int sampleRate, int bitsPerSample, int channels, size_t dataSize);
 
+private:
     static constexpr float VOLUME_MULTIPLIER = 0.9f;
 
     static std::atomic<bool> recording;
@@ -41,7 +36,6 @@ private:
 
     static void captureLoop(int secondsPerFile);
     static std::string getCurrentDateString();
-    static void writeWavHeader(std::ofstream& out, int sampleRate, int bitsPerSample, int channels, size_t dataSize);
     static bool initializeAudioDevices(IMMDeviceEnumerator** pEnumerator,
         IMMDevice** pDevice,
         IAudioClient** pAudioClient,
@@ -54,8 +48,4 @@ private:
         IAudioClient* pAudioClient,
         IMMDevice* pDevice,
         IMMDeviceEnumerator* pEnumerator);
-
-    // VAD-based sentence splitter
-    static void vadSentenceSplitter(const std::vector<BYTE>& newAudio, WAVEFORMATEX* pwfx, int& segmentIdx, const std::string& dateStr, bool forceFlush = false);
-    static float frameRMS(const int16_t* samples, size_t count);
 };
\ No newline at end of file
@@ -0,0 +1,235 @@
+#include "ingester.h"
+
+#include "external/miniaudio.h"
+
+#include "audio_capturer.h"
+#include "transcriber.h"
+#include "vad_segmenter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#define INGEST_AUDIO_DIRECTORY std::string("C:\\live-furigana\\Cache\\Ingest\\")
+#define FULL_TRANSCRIPT_DIRECTORY std::string("C:\\live-furigana\\Saved\\Transcripts\\")
+
+int Ingester::ingest(const std::vector<std::string>& inputs, int coreBudget) {
+    std::vector<Job> jobs = collectJobs(inputs);
+    if (jobs.empty()) {
+        std::cout << "No audio files to ingest" << std::endl;
+        return 0;
+    }
+
+    if (coreBudget <= 0) {
+        coreBudget = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    const int parallelJobs = std::clamp(coreBudget / THREADS_PER_JOB, 1, static_cast<int>(jobs.size()));
+    const int threadsPerJob = std::max(1, coreBudget / parallelJobs);
+
+    std::cout << "Ingesting " << jobs.size() << " files, " << parallelJobs << " at a time with "
+        << threadsPerJob << " threads each" << std::endl;
+
+    std::atomic<size_t> nextJob{ 0 };
+    std::mutex resultMutex;
+    int transcribed = 0, skipped = 0, failed = 0;
+    double audioSeconds = 0.0, speechSeconds = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        for (size_t i = nextJob++; i < jobs.size(); i = nextJob++) {
+            Result result = ingestFile(jobs[i], threadsPerJob);
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            if (result.skipped) {
+                skipped++;
+                std::cout << "Skipped " << jobs[i].outputName << " (already transcribed)" << std::endl;
+                continue;
+            }
+            if (!result.ok) {
+                failed++;
+                std::cout << "Failed " << jobs[i].inputPath.u8string() << std::endl;
+                continue;
+            }
+            transcribed++;
+            audioSeconds += result.audioSeconds;
+            speechSeconds += result.speechSeconds;
+            std::cout << "Transcribed " << jobs[i].outputName << " (" << std::fixed << std::setprecision(1)
+                << result.audioSeconds << "s audio, " << result.speechSeconds << "s speech)" << std::endl;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < parallelJobs; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Ingest finished: " << transcribed << " transcribed, " << skipped << " skipped, " << failed << " failed" << std::endl;
+    std::cout << std::fixed << std::setprecision(2)
+        << "Throughput: " << audioSeconds / 3600.0 << "h audio (" << speechSeconds / 3600.0 << "h speech) in "
+        << elapsed << "s, " << (elapsed > 0.0 ? audioSeconds / elapsed : 0.0) << "x real-time" << std::endl;
+
+    return failed;
+}
+
+std::vector<Ingester::Job> Ingester::collectJobs(const std::vector<std::string>& inputs) {
+    std::vector<std::filesystem::path> files;
+    for (const auto& input : inputs) {
+        std::filesystem::path path(input);
+        if (std::filesystem::is_directory(path)) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+                if (entry.is_regular_file() && isSupportedFile(entry.path())) {
+                    files.push_back(entry.path());
+                }
+            }
+        }
+        else if (std::filesystem::is_regular_file(path)) {
+            files.push_back(path);
+        }
+        else {
+            std::cout << "Not found: " << input << std::endl;
+        }
+    }
+
+    for (auto& file : files) {
+        file = std::filesystem::absolute(file).lexically_normal();
+    }
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+
+    std::vector<Job> jobs;
+    for (const auto& file : files) {
+        jobs.push_back({ file, outputNameFor(file) });
+    }
+    return jobs;
+}
+
+std::string Ingester::outputNameFor(const std::filesystem::path& absolutePath) {
+    // FNV-1a over the lowercased full path: the same file always maps to the same name,
+    // whatever else is scanned alongside it, and equal stems in different folders don't collide
+    std::string key = absolutePath.generic_u8string();
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+
+    // path::string() throws for names outside the ANSI code page, so the stem is taken as UTF-8 and reduced
+    // to characters that are safe in file names and in whisper-cli's narrow command line; the hash keeps it unique
+    std::string stem;
+    for (unsigned char c : absolutePath.stem().u8string()) {
+        if ((c < 0x80 && std::isalnum(c)) || c == '-' || c == '_' || c == '.') {
+            stem += static_cast<char>(c);
+        }
+        else if (stem.empty() || stem.back() != '_') {
+            stem += '_';
+        }
+    }
+    while (!stem.empty() && stem.back() == '_') {
+        stem.pop_back();
+    }
+    if (stem.empty()) {
+        stem = "audio";
+    }
+
+    std::ostringstream name;
+    name << stem << "_" << std::hex << std::setw(8) << std::setfill('0') << hash;
+    return name.str();
+}
+
+bool Ingester::isSupportedFile(const std::filesystem::path& path) {
+    // Formats with a decoder built into miniaudio
+    std::string ext = path.extension().u8string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext == ".wav" || ext == ".mp3" || ext == ".flac";
+}
+
+Ingester::Result Ingester::ingestFile(const Job& job, int threads) {
+    Result result;
+    std::string outputBase = FULL_TRANSCRIPT_DIRECTORY + job.outputName;
+    if (std::filesystem::exists(outputBase + ".txt") && std::filesystem::exists(outputBase + ".srt")) {
+        result.skipped = true;
+        return result;
+    }
+
+    ma_decoder decoder;
+    ma_decoder_config config = ma_decoder_config_init(ma_format_s16, 1, SAMPLE_RATE);
+    if (ma_decoder_init_file_w(job.inputPath.wstring().c_str(), &config, &decoder) != MA_SUCCESS) {
+        return result;
+    }
+
+    // Segments tile the whole source, so writing each one as it finishes keeps cue times in the .srt
+    // on the original file's timeline. Segments without a single speech frame are written as silence.
+    std::string wavPath = INGEST_AUDIO_DIRECTORY + job.outputName + ".wav";
+    std::ofstream out(wavPath, std::ios::binary);
+    if (!out) {
+        ma_decoder_uninit(&decoder);
+        return result;
+    }
+    AudioCapturer::writeWavHeader(out, SAMPLE_RATE, 16, 1, 0);
+
+    const size_t vadFrameSamples = SAMPLE_RATE * VadSegmenter::VAD_FRAME_MS / 1000;
+    size_t writtenSamples = 0;
+    size_t speechSamples = 0;
+
+    VadSegmenter segmenter;
+    segmenter.reset(SAMPLE_RATE, 1);
+    auto onSegment = [&](std::vector<uint8_t>& segment, float, size_t, size_t, size_t speechVadFrames) {
+        if (speechVadFrames == 0) {
+            std::fill(segment.begin(), segment.end(), static_cast<uint8_t>(0));
+        }
+        out.write(reinterpret_cast<const char*>(segment.data()), segment.size());
+        writtenSamples += segment.size() / sizeof(int16_t);
+        speechSamples += speechVadFrames * vadFrameSamples;
+    };
+
+    std::vector<int16_t> chunk(DECODE_CHUNK_FRAMES);
+    ma_uint64 totalFrames = 0;
+    while (true) {
+        ma_uint64 framesRead = 0;
+        ma_result readResult = ma_decoder_read_pcm_frames(&decoder, chunk.data(), DECODE_CHUNK_FRAMES, &framesRead);
+        if (framesRead > 0) {
+            segmenter.push(reinterpret_cast<const uint8_t*>(chunk.data()), static_cast<size_t>(framesRead) * sizeof(int16_t), onSegment);
+            totalFrames += framesRead;
+        }
+        if (readResult != MA_SUCCESS || framesRead == 0) break;
+    }
+    ma_decoder_uninit(&decoder);
+    segmenter.flush(onSegment);
+
+    // Patch the sizes now that the data length is known
+    const size_t dataSize = writtenSamples * sizeof(int16_t);
+    out.seekp(0);
+    AudioCapturer::writeWavHeader(out, SAMPLE_RATE, 16, 1, dataSize);
+    out.close();
+
+    result.audioSeconds = static_cast<double>(totalFrames) / SAMPLE_RATE;
+    result.speechSeconds = static_cast<double>(speechSamples) / SAMPLE_RATE;
+
+    // Nothing to transcribe; leave empty transcripts so the file counts as done on resume
+    if (speechSamples == 0) {
+        std::filesystem::remove(wavPath);
+        std::ofstream(outputBase + ".txt").close();
+        std::ofstream(outputBase + ".srt").close();
+        result.ok = true;
+        return result;
+    }
+
+    // The backend's index picks up the new transcript on its next rescan; this process never writes the index
+    result.ok = Transcriber::transcribeFile(wavPath, outputBase, threads);
+    std::filesystem::remove(wavPath);
+    return result;
+}
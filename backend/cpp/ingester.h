@@ -0,0 +1,44 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+class Ingester {
+public:
+    /**
+    * @brief Transcribes existing recordings offline, as fast as the machine allows
+    * @param inputs Audio files and/or directories to scan for them
+    * @param coreBudget Threads to spread across parallel jobs, 0 = all hardware threads
+    * @return Number of files that failed
+    *
+    * Each file is decoded and resampled to 16 kHz mono with miniaudio, split with the same VAD as live capture,
+    * and its speech is transcribed into "C:\\live-furigana\\Saved\\Transcripts" on the file's own timeline.
+    * Outputs are named "<ASCII-safe stem>_<hash of the full path>", and files whose transcripts already exist are skipped,
+    * so an interrupted run resumes where it stopped. The index is left to the backend, which picks up
+    * the new transcripts on its next rescan.
+    */
+    static int ingest(const std::vector<std::string>& inputs, int coreBudget = 0);
+
+private:
+    static constexpr int SAMPLE_RATE = 16000;
+    static constexpr int THREADS_PER_JOB = 4;
+    static constexpr size_t DECODE_CHUNK_FRAMES = SAMPLE_RATE; // ~1s
+
+    struct Job {
+        std::filesystem::path inputPath;
+        std::string outputName;
+    };
+
+    struct Result {
+        bool ok = false;
+        bool skipped = false;
+        double audioSeconds = 0.0;
+        double speechSeconds = 0.0;
+    };
+
+    static std::vector<Job> collectJobs(const std::vector<std::string>& inputs);
+    static std::string outputNameFor(const std::filesystem::path& absolutePath);
+    static bool isSupportedFile(const std::filesystem::path& path);
+    static Result ingestFile(const Job& job, int threads);
+};
@@ -1,16 +1,38 @@
 #include "utility.h"
 #include "audio_capturer.h"
 #include "transcriber.h"
+#include "mel_frontend.h"
+#include "ingester.h"
+#include "transcript_index.h"
+#include <stdexcept>
 #include <string>
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <vector>
 
 void printUsage() {
     std::cout << "Usage: cpp.exe [options]\n"
         << "Options:\n"
         << "--start-recording   Start in recording mode\n"
-        << "--command <cmd>     Execute command (start-recording, stop-recording, get-status, exit)\n";
+        << "--command <cmd>     Execute command (start-recording, stop-recording, get-status, get-cascade-stats,\n"
+        << "                    search <text>, bench-index [hours], validate-mel, exit)\n"
+        << "--ingest <paths>    Transcribe existing audio files or directories (wav, mp3, flac) and exit\n"
+        << "--threads <n>       Core budget for --ingest (default: all cores)\n"
+        << "--cascade           Show draft subtitles from a small model, then confirm them with the main model\n"
+        << "--draft-model <path> Draft model for --cascade (default: Saved\\Models\\ggml-small-q5_1.bin)\n";
+}
+
+// Returns fallback instead of throwing when text is not a whole positive number
+int parsePositiveInt(const std::string& text, int fallback) {
+    try {
+        size_t used = 0;
+        int value = std::stoi(text, &used);
+        return used == text.size() && value > 0 ? value : fallback;
+    }
+    catch (const std::exception&) {
+        return fallback;
+    }
 }
 
 void handleCommand(const std::string& command) {
@@ -25,9 +47,23 @@ void handleCommand(const std::string& command) {
     else if (command == "get-status") {
         std::cout << (AudioCapturer::isRecording() ? "recording" : "not-recording") << std::endl;
     }
+    else if (command == "get-cascade-stats") {
+        Transcriber::printCascadeStats();
+    }
+    else if (command.rfind("search ", 0) == 0) {
+        std::cout << TranscriptIndex::searchJson(command.substr(7)) << std::endl;
+    }
+    else if (command.rfind("bench-index", 0) == 0) {
+        int hours = command.size() > 12 ? parsePositiveInt(command.substr(12), 1000) : 1000;
+        TranscriptIndex::runBenchmark(hours);
+    }
+    else if (command == "validate-mel") {
+        std::cout << "Mel frontend validation " << (MelFrontend::validateAgainstReference() ? "passed" : "failed") << std::endl;
+    }
     else if (command == "exit") {
         AudioCapturer::stopAudioCapture();
         Transcriber::stopTranscription();
+        TranscriptIndex::shutdown();
         std::cout << "Exiting" << std::endl;
         exit(0);
     }
@@ -35,10 +71,14 @@ void handleCommand(const std::string& command) {
 
 int main(int argc, char* argv[]) {
     Utility::initializeDirectory();
-    Transcriber::startTranscription();
 
     bool shouldRecord = false;
     std::string command;
+    bool ingest = false;
+    std::vector<std::string> ingestPaths;
+    int ingestThreads = 0;
+    bool cascade = false;
+    std::string draftModel;
 
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
@@ -49,12 +89,51 @@ int main(int argc, char* argv[]) {
         else if (arg == "--command" && i + 1 < argc) {
             command = argv[++i];
         }
+        else if (arg == "--ingest") {
+            ingest = true;
+            while (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) {
+                ingestPaths.push_back(argv[++i]);
+            }
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            ingestThreads = parsePositiveInt(argv[++i], 0);
+            if (ingestThreads == 0) {
+                std::cout << "Invalid --threads value " << argv[i] << ", using all cores" << std::endl;
+            }
+        }
+        else if (arg == "--cascade") {
+            cascade = true;
+        }
+        else if (arg == "--draft-model" && i + 1 < argc) {
+            draftModel = argv[++i];
+        }
         else if (arg == "--help") {
             printUsage();
             return 0;
         }
     }
 
+    if (ingest) {
+        if (ingestPaths.empty()) {
+            printUsage();
+            return 1;
+        }
+        return Ingester::ingest(ingestPaths, ingestThreads) == 0 ? 0 : 1;
+    }
+
+    // One-shot commands only read the index, and only when they search it
+    if (command.empty()) {
+        TranscriptIndex::initialize();
+    }
+    else if (command.rfind("search ", 0) == 0) {
+        TranscriptIndex::openReadOnly();
+    }
+
+    if (cascade) {
+        Transcriber::enableCascade(draftModel);
+    }
+    Transcriber::startTranscription();
+
     if (!command.empty()) {
         handleCommand(command);
         return 0;
@@ -74,5 +153,6 @@ int main(int argc, char* argv[]) {
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
 
+    TranscriptIndex::shutdown();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,578 @@
+#include "mel_frontend.h"
+
+#include "external/miniaudio.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+    constexpr double PI = 3.14159265358979323846;
+    constexpr int FFT_SIZE = MelFrontend::N_FFT / 2;   // Complex FFT size used for the real transform
+    constexpr int FFT_ODD = 25;                         // 200 = 2 * 2 * 2 * 25
+
+    struct Tables {
+        std::vector<float> hann;                        // Periodic Hann window, N_FFT points
+        std::vector<std::vector<float>> twRe, twIm;     // Radix-2 twiddles for sizes 200, 100, 50
+        std::vector<float> dftRe, dftIm;                // FFT_ODD x FFT_ODD DFT matrix
+        std::vector<float> splitRe, splitIm;            // e^{-2*pi*i*k/N_FFT}, k = 0..N_FFT/2
+        std::vector<float> filters;                     // N_MEL x N_BINS Slaney mel filterbank
+    };
+
+    double hzToMel(double hz) {
+        const double fSp = 200.0 / 3.0;
+        const double minLogHz = 1000.0;
+        const double minLogMel = minLogHz / fSp;
+        const double logStep = std::log(6.4) / 27.0;
+        return hz < minLogHz ? hz / fSp : minLogMel + std::log(hz / minLogHz) / logStep;
+    }
+
+    double melToHz(double mel) {
+        const double fSp = 200.0 / 3.0;
+        const double minLogHz = 1000.0;
+        const double minLogMel = minLogHz / fSp;
+        const double logStep = std::log(6.4) / 27.0;
+        return mel < minLogMel ? mel * fSp : minLogHz * std::exp(logStep * (mel - minLogMel));
+    }
+
+    // Same construction as librosa.filters.mel(sr=16000, n_fft=400, n_mels=80), which produced Whisper's mel_filters.npz
+    std::vector<float> buildFilterbank() {
+        const int nMel = MelFrontend::N_MEL;
+        const int nBins = MelFrontend::N_BINS;
+        std::vector<float> filters(nMel * nBins, 0.0f);
+
+        const double maxMel = hzToMel(MelFrontend::SAMPLE_RATE / 2.0);
+        std::vector<double> melHz(nMel + 2);
+        for (int i = 0; i < nMel + 2; ++i) {
+            melHz[i] = melToHz(maxMel * i / (nMel + 1));
+        }
+
+        for (int m = 0; m < nMel; ++m) {
+            const double lowDiff = melHz[m + 1] - melHz[m];
+            const double highDiff = melHz[m + 2] - melHz[m + 1];
+            const double enorm = 2.0 / (melHz[m + 2] - melHz[m]);
+            for (int k = 0; k < nBins; ++k) {
+                const double hz = static_cast<double>(k) * MelFrontend::SAMPLE_RATE / MelFrontend::N_FFT;
+                const double lower = (hz - melHz[m]) / lowDiff;
+                const double upper = (melHz[m + 2] - hz) / highDiff;
+                const double weight = std::max(0.0, std::min(lower, upper));
+                filters[m * nBins + k] = static_cast<float>(weight * enorm);
+            }
+        }
+        return filters;
+    }
+
+    Tables buildTables() {
+        Tables t;
+        t.hann.resize(MelFrontend::N_FFT);
+        for (int i = 0; i < MelFrontend::N_FFT; ++i) {
+            t.hann[i] = static_cast<float>(0.5 * (1.0 - std::cos(2.0 * PI * i / MelFrontend::N_FFT)));
+        }
+
+        for (int n = FFT_SIZE; n > FFT_ODD; n /= 2) {
+            std::vector<float> re(n / 2), im(n / 2);
+            for (int k = 0; k < n / 2; ++k) {
+                re[k] = static_cast<float>(std::cos(2.0 * PI * k / n));
+                im[k] = static_cast<float>(-std::sin(2.0 * PI * k / n));
+            }
+            t.twRe.push_back(std::move(re));
+            t.twIm.push_back(std::move(im));
+        }
+
+        t.dftRe.resize(FFT_ODD * FFT_ODD);
+        t.dftIm.resize(FFT_ODD * FFT_ODD);
+        for (int k = 0; k < FFT_ODD; ++k) {
+            for (int j = 0; j < FFT_ODD; ++j) {
+                const int idx = (j * k) % FFT_ODD;
+                t.dftRe[k * FFT_ODD + j] = static_cast<float>(std::cos(2.0 * PI * idx / FFT_ODD));
+                t.dftIm[k * FFT_ODD + j] = static_cast<float>(-std::sin(2.0 * PI * idx / FFT_ODD));
+            }
+        }
+
+        t.splitRe.resize(FFT_SIZE + 1);
+        t.splitIm.resize(FFT_SIZE + 1);
+        for (int k = 0; k <= FFT_SIZE; ++k) {
+            t.splitRe[k] = static_cast<float>(std::cos(2.0 * PI * k / MelFrontend::N_FFT));
+            t.splitIm[k] = static_cast<float>(-std::sin(2.0 * PI * k / MelFrontend::N_FFT));
+        }
+
+        t.filters = buildFilterbank();
+        return t;
+    }
+
+    const Tables& tables() {
+        static const Tables t = buildTables();
+        return t;
+    }
+
+    // Decimation-in-time FFT over in[j * stride], written as split real/imaginary arrays so the
+    // butterfly and DFT loops are contiguous and auto-vectorize
+    void fftRecursive(const float* inRe, const float* inIm, int n, int stride, float* outRe, float* outIm, int level) {
+        const Tables& t = tables();
+
+        if (n == FFT_ODD) {
+            float re[FFT_ODD], im[FFT_ODD];
+            for (int j = 0; j < FFT_ODD; ++j) {
+                re[j] = inRe[j * stride];
+                im[j] = inIm[j * stride];
+            }
+            for (int k = 0; k < FFT_ODD; ++k) {
+                const float* wRe = &t.dftRe[k * FFT_ODD];
+                const float* wIm = &t.dftIm[k * FFT_ODD];
+                float sumRe = 0.0f, sumIm = 0.0f;
+                for (int j = 0; j < FFT_ODD; ++j) {
+                    sumRe += re[j] * wRe[j] - im[j] * wIm[j];
+                    sumIm += re[j] * wIm[j] + im[j] * wRe[j];
+                }
+                outRe[k] = sumRe;
+                outIm[k] = sumIm;
+            }
+            return;
+        }
+
+        const int half = n / 2;
+        fftRecursive(inRe, inIm, half, stride * 2, outRe, outIm, level + 1);
+        fftRecursive(inRe + stride, inIm + stride, half, stride * 2, outRe + half, outIm + half, level + 1);
+
+        const float* wRe = t.twRe[level].data();
+        const float* wIm = t.twIm[level].data();
+        for (int k = 0; k < half; ++k) {
+            const float oRe = outRe[k + half] * wRe[k] - outIm[k + half] * wIm[k];
+            const float oIm = outRe[k + half] * wIm[k] + outIm[k + half] * wRe[k];
+            const float eRe = outRe[k];
+            const float eIm = outIm[k];
+            outRe[k] = eRe + oRe;
+            outIm[k] = eIm + oIm;
+            outRe[k + half] = eRe - oRe;
+            outIm[k + half] = eIm - oIm;
+        }
+    }
+}
+
+struct MelFrontend::Resampler {
+    ma_resampler state;
+
+    ~Resampler() {
+        ma_resampler_uninit(&state, nullptr);
+    }
+};
+
+MelFrontend::MelFrontend(size_t ringFrames)
+    : ringCapacity(std::max<size_t>(ringFrames, 1)),
+    melRing(ringCapacity * N_MEL, 0.0f),
+    bandRing(ringCapacity, 0.0f),
+    fftRe(FFT_HALF), fftIm(FFT_HALF), scratchRe(FFT_HALF), scratchIm(FFT_HALF), power(N_BINS) {
+    tables();
+}
+
+MelFrontend::~MelFrontend() = default;
+
+void MelFrontend::reset(int inputSampleRate, int inputChannels) {
+    inputRate = inputSampleRate > 0 ? inputSampleRate : SAMPLE_RATE;
+    channels = inputChannels > 0 ? inputChannels : 1;
+
+    // Same resampler whisper-cli reads WAVs with: linear interpolation behind miniaudio's
+    // default low-pass filter (order MA_DEFAULT_RESAMPLER_LPF_ORDER), which keeps content
+    // above 8 kHz from aliasing into the speech band
+    resampler.reset();
+    if (inputRate != SAMPLE_RATE) {
+        auto next = std::make_unique<Resampler>();
+        ma_resampler_config config = ma_resampler_config_init(ma_format_f32, 1, static_cast<ma_uint32>(inputRate), SAMPLE_RATE, ma_resample_algorithm_linear);
+        if (ma_resampler_init(&config, nullptr, &next->state) == MA_SUCCESS) {
+            resampler = std::move(next);
+        }
+        else {
+            // Unsupported rate; frames would be mistimed, so emit none rather than wrong ones
+            inputRate = 0;
+        }
+    }
+    resampled.resize(RESAMPLE_CHUNK_FRAMES);
+
+    primed = false;
+    frameInput.clear();
+    framesEmitted = 0;
+}
+
+void MelFrontend::pushPcm(const int16_t* samples, size_t frameCount) {
+    if (inputRate == 0) return;
+
+    // Downmix to mono float
+    downmixed.resize(frameCount);
+    for (size_t f = 0; f < frameCount; ++f) {
+        float sum = 0.0f;
+        for (int c = 0; c < channels; ++c) {
+            sum += samples[f * channels + c];
+        }
+        downmixed[f] = sum / (channels * 32768.0f);
+    }
+
+    if (!resampler) {
+        for (float v : downmixed) {
+            appendResampled(v);
+        }
+        return;
+    }
+
+    const float* input = downmixed.data();
+    ma_uint64 remaining = frameCount;
+    while (remaining > 0) {
+        ma_uint64 inputFrames = remaining;
+        ma_uint64 outputFrames = resampled.size();
+        if (ma_resampler_process_pcm_frames(&resampler->state, input, &inputFrames, resampled.data(), &outputFrames) != MA_SUCCESS) break;
+
+        for (ma_uint64 i = 0; i < outputFrames; ++i) {
+            appendResampled(resampled[static_cast<size_t>(i)]);
+        }
+        if (inputFrames == 0 && outputFrames == 0) break;
+        input += inputFrames;
+        remaining -= inputFrames;
+    }
+}
+
+size_t MelFrontend::totalFrames() const {
+    return framesEmitted;
+}
+
+size_t MelFrontend::oldestFrame() const {
+    return framesEmitted > ringCapacity ? framesEmitted - ringCapacity : 0;
+}
+
+size_t MelFrontend::copyNormalizedFrames(size_t begin, size_t end, float gain, std::vector<float>& out) const {
+    begin = std::max(begin, oldestFrame());
+    end = std::min(end, totalFrames());
+    if (begin >= end) {
+        out.clear();
+        return 0;
+    }
+
+    // Scaling PCM by gain shifts log10 power by 2 * log10(gain)
+    const float offset = gain > 0.0f ? 2.0f * std::log10(gain) : 0.0f;
+    const size_t count = end - begin;
+
+    float mmax = -1e20f;
+    for (size_t f = begin; f < end; ++f) {
+        const float* frame = &melRing[(f % ringCapacity) * N_MEL];
+        for (int m = 0; m < N_MEL; ++m) {
+            mmax = std::max(mmax, frame[m] + offset);
+        }
+    }
+
+    // Whisper normalization: clamp to 8 decades below the peak, then (x + 4) / 4
+    out.resize(N_MEL * count);
+    for (size_t f = begin; f < end; ++f) {
+        const float* frame = &melRing[(f % ringCapacity) * N_MEL];
+        for (int m = 0; m < N_MEL; ++m) {
+            const float v = std::max(frame[m] + offset, mmax - 8.0f);
+            out[m * count + (f - begin)] = (v + 4.0f) / 4.0f;
+        }
+    }
+    return count;
+}
+
+float MelFrontend::speechBandPower(size_t begin, size_t end) const {
+    begin = std::max(begin, oldestFrame());
+    end = std::min(end, totalFrames());
+    if (begin >= end) return -1.0f;
+
+    float sum = 0.0f;
+    for (size_t f = begin; f < end; ++f) {
+        sum += bandRing[f % ringCapacity];
+    }
+    return sum / (end - begin);
+}
+
+void MelFrontend::appendResampled(float sample) {
+    frameInput.push_back(sample);
+
+    // whisper.cpp reflect-pads the first N_FFT / 2 samples, so hold off until that many are known
+    if (!primed) {
+        if (frameInput.size() < FFT_HALF + 1) return;
+        std::vector<float> padded(FFT_HALF);
+        for (int i = 0; i < FFT_HALF; ++i) {
+            padded[i] = frameInput[FFT_HALF - i];
+        }
+        frameInput.insert(frameInput.begin(), padded.begin(), padded.end());
+        primed = true;
+    }
+
+    while (frameInput.size() >= N_FFT) {
+        emitFrame();
+        frameInput.erase(frameInput.begin(), frameInput.begin() + HOP_LENGTH);
+    }
+}
+
+void MelFrontend::emitFrame() {
+    computePower(frameInput.data());
+
+    const size_t slot = framesEmitted % ringCapacity;
+    applyFilterbank(power.data(), &melRing[slot * N_MEL]);
+    bandRing[slot] = bandPower(power.data());
+    framesEmitted++;
+}
+
+void MelFrontend::computePower(const float* frame) {
+    const Tables& t = tables();
+
+    // Pack even/odd samples as real/imaginary parts of a half-size complex FFT
+    for (int n = 0; n < FFT_HALF; ++n) {
+        scratchRe[n] = frame[2 * n] * t.hann[2 * n];
+        scratchIm[n] = frame[2 * n + 1] * t.hann[2 * n + 1];
+    }
+    fftRecursive(scratchRe.data(), scratchIm.data(), FFT_HALF, 1, fftRe.data(), fftIm.data(), 0);
+
+    // Split back into the spectrum of the real signal
+    for (int k = 0; k <= FFT_HALF; ++k) {
+        const int a = k % FFT_HALF;
+        const int b = (FFT_HALF - k) % FFT_HALF;
+        const float evenRe = 0.5f * (fftRe[a] + fftRe[b]);
+        const float evenIm = 0.5f * (fftIm[a] - fftIm[b]);
+        const float oddRe = 0.5f * (fftIm[a] + fftIm[b]);
+        const float oddIm = -0.5f * (fftRe[a] - fftRe[b]);
+        const float re = evenRe + oddRe * t.splitRe[k] - oddIm * t.splitIm[k];
+        const float im = evenIm + oddRe * t.splitIm[k] + oddIm * t.splitRe[k];
+        power[k] = re * re + im * im;
+    }
+}
+
+void MelFrontend::applyFilterbank(const float* power, float* melOut) {
+    const Tables& t = tables();
+    for (int m = 0; m < N_MEL; ++m) {
+        const float* filter = &t.filters[m * N_BINS];
+        float sum = 0.0f;
+        for (int k = 0; k < N_BINS; ++k) {
+            sum += filter[k] * power[k];
+        }
+        melOut[m] = std::log10(std::max(sum, 1e-10f));
+    }
+}
+
+float MelFrontend::bandPower(const float* power) {
+    const int low = static_cast<int>(std::ceil(SPEECH_BAND_LOW_HZ * N_FFT / SAMPLE_RATE));
+    const int high = static_cast<int>(SPEECH_BAND_HIGH_HZ * N_FFT / SAMPLE_RATE);
+    float band = 0.0f;
+    for (int k = low; k <= high; ++k) {
+        band += power[k];
+    }
+
+    // Parseval over the one-sided spectrum, divided by the Hann window's energy (3 * N_FFT / 8)
+    // so a full-scale sine in the band reads 0.5, the same as its mean square
+    const float windowEnergy = 3.0f * N_FFT / 8.0f;
+    return 2.0f * band / (N_FFT * windowEnergy);
+}
+
+std::vector<float> MelFrontend::referenceLogMel(const float* samples, size_t n) {
+    const size_t nFrames = n / HOP_LENGTH;
+
+    // Window in double, independent of the frontend's tables
+    std::vector<double> hann(N_FFT);
+    for (int j = 0; j < N_FFT; ++j) {
+        hann[j] = 0.5 - 0.5 * std::cos(2.0 * PI * j / N_FFT);
+    }
+
+    // Reflect-pad N_FFT / 2 at the start, zero-pad the end (whisper.cpp adds 30s of zeros)
+    std::vector<double> padded(FFT_HALF + n + nFrames * HOP_LENGTH + N_FFT, 0.0);
+    for (int i = 0; i < FFT_HALF && static_cast<size_t>(FFT_HALF - i) < n; ++i) {
+        padded[i] = samples[FFT_HALF - i];
+    }
+    for (size_t i = 0; i < n; ++i) {
+        padded[FFT_HALF + i] = samples[i];
+    }
+
+    std::vector<float> mel(nFrames * N_MEL);
+    std::vector<float> framePower(N_BINS);
+    for (size_t f = 0; f < nFrames; ++f) {
+        const double* frame = &padded[f * HOP_LENGTH];
+        for (int k = 0; k < N_BINS; ++k) {
+            double re = 0.0, im = 0.0;
+            for (int j = 0; j < N_FFT; ++j) {
+                const double v = frame[j] * hann[j];
+                const double angle = 2.0 * PI * ((static_cast<long long>(k) * j) % N_FFT) / N_FFT;
+                re += v * std::cos(angle);
+                im -= v * std::sin(angle);
+            }
+            framePower[k] = static_cast<float>(re * re + im * im);
+        }
+        applyFilterbank(framePower.data(), &mel[f * N_MEL]);
+    }
+    return mel;
+}
+
+namespace {
+    // Feeds PCM in uneven chunks so buffering across pushPcm calls is exercised
+    void pushInChunks(MelFrontend& frontend, const std::vector<int16_t>& pcm, int channels) {
+        const size_t frames = pcm.size() / channels;
+        size_t offset = 0;
+        for (size_t chunk = 0; offset < frames; ++chunk) {
+            const size_t size = std::min<size_t>(1 + (chunk * 7919) % 1500, frames - offset);
+            frontend.pushPcm(&pcm[offset * channels], size);
+            offset += size;
+        }
+    }
+
+    // Chirp from 100 Hz to 6.1 kHz over a steady 440 Hz tone, sampled at rate. The optional noise floor
+    // is white, so it is only used at 16 kHz where no resampler decides how much of it survives
+    double testSignal(size_t i, int rate, uint32_t* seed) {
+        const double time = static_cast<double>(i) / rate;
+        const double phase = 2.0 * PI * (100.0 * time + 1000.0 * time * time);
+        double v = 0.3 * std::sin(phase) + 0.05 * std::sin(2.0 * PI * 440.0 * time);
+        if (seed) {
+            *seed = *seed * 1664525u + 1013904223u;
+            v += (static_cast<double>(*seed >> 8) / (1 << 24) - 0.5) * 0.04;
+        }
+        return v;
+    }
+
+    int16_t toPcm(double v) {
+        return static_cast<int16_t>(std::lround(std::clamp(v, -1.0, 1.0) * 32767.0));
+    }
+
+    // Whisper normalization of frame-major log10 mel into the mel-major layout copyNormalizedFrames returns
+    std::vector<float> normalizeReference(const std::vector<float>& logMel, size_t frames) {
+        float mmax = -1e20f;
+        for (size_t i = 0; i < frames * MelFrontend::N_MEL; ++i) {
+            mmax = std::max(mmax, logMel[i]);
+        }
+        std::vector<float> out(frames * MelFrontend::N_MEL);
+        for (size_t f = 0; f < frames; ++f) {
+            for (int m = 0; m < MelFrontend::N_MEL; ++m) {
+                const float v = std::max(logMel[f * MelFrontend::N_MEL + m], mmax - 8.0f);
+                out[m * frames + f] = (v + 4.0f) / 4.0f;
+            }
+        }
+        return out;
+    }
+
+    bool report(const char* name, float value, float limit) {
+        const bool pass = value <= limit;
+        std::cout << name << ": " << value << " (limit " << limit << ") "
+            << (pass ? "PASS" : "FAIL") << std::endl;
+        return pass;
+    }
+}
+
+bool MelFrontend::validateAgainstReference() {
+    bool pass = true;
+
+    // Peaks of a few filters from librosa.filters.mel(sr=16000, n_fft=400, n_mels=80), as shipped in Whisper's mel_filters.npz
+    {
+        struct Coefficient { int mel; int bin; float value; };
+        const Coefficient expected[] = {
+            { 0, 1, 0.024862595f }, { 1, 2, 0.022871772f }, { 20, 20, 0.013890394f },
+            { 40, 43, 0.014735566f }, { 60, 93, 0.0065910928f }, { 79, 192, 0.0031647116f },
+        };
+        float maxError = 0.0f;
+        for (const auto& c : expected) {
+            maxError = std::max(maxError, std::abs(tables().filters[c.mel * N_BINS + c.bin] - c.value));
+        }
+        pass &= report("Filterbank max error", maxError, FILTERBANK_TOLERANCE);
+    }
+
+    // 16 kHz mono, no resampling: raw log10 mel against the direct DFT
+    {
+        const size_t n = SAMPLE_RATE * 3;
+        std::vector<int16_t> pcm(n);
+        std::vector<float> reference(n);
+        uint32_t seed = 12345;
+        for (size_t i = 0; i < n; ++i) {
+            pcm[i] = toPcm(testSignal(i, SAMPLE_RATE, &seed));
+            reference[i] = pcm[i] / 32768.0f;
+        }
+
+        MelFrontend frontend(n / HOP_LENGTH + 1);
+        frontend.reset(SAMPLE_RATE, 1);
+        pushInChunks(frontend, pcm, 1);
+
+        const std::vector<float> expected = referenceLogMel(reference.data(), n);
+        const size_t frames = std::min(frontend.totalFrames(), expected.size() / N_MEL);
+        float maxError = 0.0f;
+        for (size_t f = 0; f < frames; ++f) {
+            for (int m = 0; m < N_MEL; ++m) {
+                maxError = std::max(maxError, std::abs(frontend.melRing[f * N_MEL + m] - expected[f * N_MEL + m]));
+            }
+        }
+        pass &= report("16 kHz mono max error", maxError, NATIVE_RATE_TOLERANCE);
+    }
+
+    // 48 kHz stereo with unequal channels: normalized mel against a windowed-sinc decimation of the downmix
+    {
+        const int rate = 48000;
+        const int factor = rate / SAMPLE_RATE;
+        const size_t n = static_cast<size_t>(rate) * 3;
+        std::vector<int16_t> pcm(n * 2);
+        std::vector<double> mono(n);
+        for (size_t i = 0; i < n; ++i) {
+            const double v = testSignal(i, rate, nullptr);
+            pcm[i * 2] = toPcm(1.2 * v);
+            pcm[i * 2 + 1] = toPcm(0.8 * v);
+            mono[i] = (pcm[i * 2] + pcm[i * 2 + 1]) / (2.0 * 32768.0);
+        }
+
+        MelFrontend frontend(n / factor / HOP_LENGTH + 1);
+        frontend.reset(rate, 2);
+        pushInChunks(frontend, pcm, 2);
+
+        // Blackman-windowed sinc low-pass at 7.6 kHz, then every third sample. The kernel is delayed by the
+        // resampler's reported input latency so both outputs line up in time
+        const long long latency = static_cast<long long>(ma_resampler_get_input_latency(&frontend.resampler->state));
+        const int taps = 64 * factor + 1;
+        const int halfTaps = taps / 2;
+        const double cutoff = 7600.0 / rate;
+        std::vector<double> kernel(taps);
+        double kernelSum = 0.0;
+        for (int j = 0; j < taps; ++j) {
+            const double x = j - halfTaps;
+            const double sinc = x == 0.0 ? 2.0 * cutoff : std::sin(2.0 * PI * cutoff * x) / (PI * x);
+            const double window = 0.42 - 0.5 * std::cos(2.0 * PI * j / (taps - 1)) + 0.08 * std::cos(4.0 * PI * j / (taps - 1));
+            kernel[j] = sinc * window;
+            kernelSum += kernel[j];
+        }
+        const size_t outN = n / factor;
+        std::vector<float> reference(outN);
+        for (size_t i = 0; i < outN; ++i) {
+            double sum = 0.0;
+            for (int j = 0; j < taps; ++j) {
+                const long long index = static_cast<long long>(i) * factor + j - halfTaps - latency;
+                if (index >= 0 && index < static_cast<long long>(n)) sum += mono[index] * kernel[j];
+            }
+            reference[i] = static_cast<float>(sum / kernelSum);
+        }
+
+        const std::vector<float> expectedLog = referenceLogMel(reference.data(), outN);
+        const size_t frames = std::min(frontend.totalFrames(), expectedLog.size() / N_MEL);
+        std::vector<float> actual;
+        frontend.copyNormalizedFrames(0, frames, 1.0f, actual);
+        const std::vector<float> expected = normalizeReference(expectedLog, frames);
+
+        // The resampler's filter starts from silence, so leave out the frames its start-up transient reaches
+        float maxError = 0.0f;
+        for (size_t i = 0; i < expected.size(); ++i) {
+            if (i % frames < 3) continue;
+            maxError = std::max(maxError, std::abs(actual[i] - expected[i]));
+        }
+        pass &= report("48 kHz stereo max error", maxError, RESAMPLED_TOLERANCE);
+    }
+
+    // 13 kHz tone at 48 kHz: the resampler must keep it from aliasing down to 3 kHz
+    {
+        const int rate = 48000;
+        const size_t n = rate;
+        std::vector<int16_t> pcm(n * 2);
+        double fullBand = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const double v = 0.5 * std::sin(2.0 * PI * 13000.0 * i / rate);
+            pcm[i * 2] = pcm[i * 2 + 1] = toPcm(v);
+            fullBand += v * v;
+        }
+        fullBand /= n;
+
+        MelFrontend frontend(SAMPLE_RATE / HOP_LENGTH + 1);
+        frontend.reset(rate, 2);
+        pushInChunks(frontend, pcm, 2);
+
+        // Skip the reflect-padded edges
+        const float share = frontend.speechBandPower(5, frontend.totalFrames() - 5) / static_cast<float>(fullBand);
+        pass &= report("13 kHz tone speech-band share", share, ALIAS_BAND_SHARE_LIMIT);
+    }
+
+    return pass;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class MelFrontend {
+public:
+    /**
+    * @brief Incremental Whisper log-mel frontend for the capture stream
+    *
+    * Interleaved 16-bit PCM at the capture rate is downmixed, resampled to 16 kHz with miniaudio's
+    * low-pass filtered linear resampler and cut into 25 ms Hann windows every 10 ms. Each window goes
+    * through a 400-point real FFT and the 80-band Whisper (Slaney) filterbank, and the resulting log10
+    * mel frame is pushed into a fixed-size ring together with its speech-band power.
+    *
+    * Frame i is centred on 16 kHz sample i * HOP_LENGTH of the stream, so a segment that
+    * spans [t0, t1) seconds maps to frames [t0 * 100, t1 * 100).
+    */
+    static constexpr int SAMPLE_RATE = 16000;
+    static constexpr int N_FFT = 400;
+    static constexpr int HOP_LENGTH = 160;
+    static constexpr int N_MEL = 80;
+    static constexpr int N_BINS = N_FFT / 2 + 1;
+    static constexpr size_t DEFAULT_RING_FRAMES = 3000; // 30s, one Whisper window
+
+    explicit MelFrontend(size_t ringFrames = DEFAULT_RING_FRAMES);
+    ~MelFrontend();
+
+    MelFrontend(const MelFrontend&) = delete;
+    MelFrontend& operator=(const MelFrontend&) = delete;
+
+    void reset(int inputSampleRate, int inputChannels);
+    void pushPcm(const int16_t* samples, size_t frameCount);
+
+    size_t totalFrames() const;
+    size_t oldestFrame() const;
+
+    /**
+    * @brief Copies frames [begin, end) still held by the ring, normalized the way Whisper does
+    * @param gain Linear gain applied to the PCM after capture (e.g. segment peak normalization)
+    * @param out Receives N_MEL rows of (returned) frames each, mel-major like whisper_set_mel
+    * @return Number of frames copied
+    */
+    size_t copyNormalizedFrames(size_t begin, size_t end, float gain, std::vector<float>& out) const;
+
+    /**
+    * @brief Mean-square power between 300 Hz and 3400 Hz over frames [begin, end), in the same units as PCM RMS squared
+    *
+    * Dividing by the full-band power measured at the capture rate gives the speech-band share, which also
+    * counts energy above 8 kHz that the resampler removes. Returns a negative value when none of the frames
+    * are available, so callers can fall back to energy only.
+    */
+    float speechBandPower(size_t begin, size_t end) const;
+
+    /**
+    * @brief Direct-DFT reference of the raw log10 mel spectrogram, padded the same way as whisper.cpp
+    * @return n / HOP_LENGTH frames, frame-major
+    */
+    static std::vector<float> referenceLogMel(const float* samples, size_t n);
+
+    /**
+    * @brief Checks the filterbank against Whisper's coefficients, then streams synthetic 16 kHz mono and
+    * 48 kHz stereo signals through the frontend in uneven chunks and compares them to referenceLogMel
+    * @return true when every case is within its tolerance, details are printed per case
+    *
+    * The 48 kHz reference is downmixed and decimated with a long windowed-sinc filter, and compared after
+    * Whisper normalization. A 13 kHz tone must also stay out of the speech band after resampling.
+    */
+    static bool validateAgainstReference();
+
+private:
+    static constexpr int FFT_HALF = N_FFT / 2;
+    static constexpr float SPEECH_BAND_LOW_HZ = 300.0f;
+    static constexpr float SPEECH_BAND_HIGH_HZ = 3400.0f;
+    static constexpr size_t RESAMPLE_CHUNK_FRAMES = 4096;
+
+    static constexpr float FILTERBANK_TOLERANCE = 1e-6f;
+    static constexpr float NATIVE_RATE_TOLERANCE = 1e-3f;     // log10 units, 16 kHz mono
+    static constexpr float RESAMPLED_TOLERANCE = 0.05f;       // Whisper-normalized units, 48 kHz stereo
+    static constexpr float ALIAS_BAND_SHARE_LIMIT = 0.05f;
+
+    struct Resampler;
+
+    int inputRate = SAMPLE_RATE;
+    int channels = 1;
+
+    std::unique_ptr<Resampler> resampler; // Null when the input is already 16 kHz
+    std::vector<float> downmixed;
+    std::vector<float> resampled;
+
+    bool primed = false;
+    std::vector<float> frameInput;
+
+    size_t ringCapacity;
+    size_t framesEmitted = 0;
+    std::vector<float> melRing;
+    std::vector<float> bandRing;
+
+    std::vector<float> fftRe, fftIm, scratchRe, scratchIm, power;
+
+    void appendResampled(float sample);
+    void emitFrame();
+    void computePower(const float* frame);
+
+    static void applyFilterbank(const float* power, float* melOut);
+    static float bandPower(const float* power);
+};
@@ -0,0 +1,11 @@
+// miniaudio implementation, shared by the ingester's decoder and the mel frontend's resampler.
+// Only decoding and resampling are used; must come before anything that pulls in windows.h
+#define NOMINMAX
+#define MA_NO_DEVICE_IO
+#define MA_NO_ENGINE
+#define MA_NO_NODE_GRAPH
+#define MA_NO_RESOURCE_MANAGER
+#define MA_NO_ENCODING
+#define MA_NO_GENERATION
+#define MINIAUDIO_IMPLEMENTATION
+#include "external/miniaudio.h"
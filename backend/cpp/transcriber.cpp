@@ -1,38 +1,92 @@
 #include "transcriber.h"
 #include "utility.h"
+#include "transcript_index.h"
 
 #include <windows.h>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iomanip>
+#include <sstream>
 #include <chrono>
 
 #define SEGMENTED_AUDIO_DIRECTORY std::string("C:\\live-furigana\\Cache\\Audios\\")
 #define SEGMENTED_TRANSCRIPT_DIRECTORY std::string("C:\\live-furigana\\Cache\\Transcripts\\")
 #define FULL_AUDIO_DIRECTORY std::string("C:\\live-furigana\\Saved\\Audios\\")
 #define FULL_TRANSCRIPT_DIRECTORY std::string("C:\\live-furigana\\Saved\\Transcripts\\")
+#define CONFIRM_TRANSCRIPT_DIRECTORY std::string("C:\\live-furigana\\Cache\\Confirm\\")
 
 std::string exeDir = Utility::getExecutableDir();
 std::string whisperExe = exeDir + "external\\whisper.cpp\\whisper-cli.exe";
 std::string modelPath = "C:\\live-furigana\\Saved\\Models\\ggml-medium.bin";
+std::string defaultDraftModelPath = "C:\\live-furigana\\Saved\\Models\\ggml-small-q5_1.bin";
 
 std::atomic<bool> Transcriber::running{ false };
 std::thread Transcriber::monitorThread;
 std::set<std::string> Transcriber::processedFiles;
 
+std::atomic<bool> Transcriber::cascadeEnabled{ false };
+std::string Transcriber::draftModelPath;
+std::thread Transcriber::confirmThread;
+std::deque<Transcriber::ConfirmJob> Transcriber::confirmQueue;
+std::mutex Transcriber::confirmMutex;
+std::condition_variable Transcriber::confirmCondition;
+Transcriber::CascadeStats Transcriber::cascadeStats;
+
 void Transcriber::startTranscription() {
     if (running) return;
 
     running = true;
     monitorThread = std::thread(monitorAudioDirectory);
+    if (cascadeEnabled) {
+        confirmThread = std::thread(confirmLoop);
+    }
 }
 
 void Transcriber::stopTranscription() {
     if (!running) return;
 
-    running = false;
+    {
+        std::lock_guard<std::mutex> lock(confirmMutex);
+        running = false;
+    }
+    confirmCondition.notify_all();
     if (monitorThread.joinable()) {
         monitorThread.join();
     }
+    if (confirmThread.joinable()) {
+        confirmThread.join();
+    }
+}
+
+void Transcriber::enableCascade(const std::string& draftModel) {
+    std::string path = draftModel.empty() ? defaultDraftModelPath : draftModel;
+    if (!std::filesystem::exists(path)) {
+        std::cout << "Draft model not found: " << path << ", cascade disabled" << std::endl;
+        return;
+    }
+    draftModelPath = path;
+    cascadeEnabled = true;
+}
+
+void Transcriber::printCascadeStats() {
+    if (!cascadeEnabled) {
+        std::cout << "Cascade disabled" << std::endl;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(confirmMutex);
+    const CascadeStats& st = cascadeStats;
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1)
+        << "Cascade: drafts=" << st.drafts
+        << " confirms=" << st.confirms
+        << " replaced=" << st.replaced << " (" << (st.confirms > 0 ? 100.0 * st.replaced / st.confirms : 0.0) << "%)"
+        << " skipped=" << st.skipped
+        << " failed=" << st.failed
+        << " draft-latency avg=" << (st.drafts > 0 ? st.draftMsTotal / st.drafts : 0.0) << "ms max=" << st.draftMsMax << "ms"
+        << " confirm-latency avg=" << (st.confirms > 0 ? st.confirmMsTotal / st.confirms : 0.0) << "ms max=" << st.confirmMsMax << "ms";
+    std::cout << oss.str() << std::endl;
 }
 
 void Transcriber::monitorAudioDirectory() {
@@ -42,9 +96,15 @@ void Transcriber::monitorAudioDirectory() {
                 std::string filePath = entry.path().string();
 
                 if (processedFiles.find(filePath) == processedFiles.end()) {
+                    auto detectedAt = std::chrono::steady_clock::now();
                     std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
-                    transcribeFile(filePath);
+                    if (cascadeEnabled) {
+                        transcribeSegmentCascade(filePath, detectedAt);
+                    }
+                    else {
+                        transcribeFile(filePath);
+                    }
                     processedFiles.insert(filePath);
                 }
             }
@@ -67,7 +127,92 @@ void Transcriber::monitorAudioDirectory() {
     }
 }
 
-bool Transcriber::runProcessWithWorkingDir(const std::string& command, const std::string& workingDir) {
+void Transcriber::confirmLoop() {
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+
+    while (true) {
+        ConfirmJob job;
+        {
+            std::unique_lock<std::mutex> lock(confirmMutex);
+            confirmCondition.wait(lock, [] { return !running || !confirmQueue.empty(); });
+            if (!running) break;
+
+            job = confirmQueue.front();
+            confirmQueue.pop_front();
+
+            // Too late to be worth replacing what is already on screen
+            if (std::chrono::steady_clock::now() - job.detectedAt > std::chrono::milliseconds(CONFIRM_MAX_LAG_MS)) {
+                cascadeStats.skipped++;
+                continue;
+            }
+        }
+
+        std::string stem = std::filesystem::path(job.audioFilePath).stem().string();
+        std::string confirmBase = CONFIRM_TRANSCRIPT_DIRECTORY + stem;
+        bool success = runWhisper(modelPath, job.audioFilePath, confirmBase, 0, true);
+        std::string confirmedText = success ? readTranscript(confirmBase + ".txt") : "";
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - job.detectedAt).count();
+
+        // An empty confirm replaces too: the draft was most likely a hallucination on noise, and the
+        // empty file tells the frontend to drop that line
+        bool replaced = success && confirmedText != job.draftText;
+        if (replaced) {
+            // Write then rename so the frontend never sees a partial file
+            std::string target = SEGMENTED_TRANSCRIPT_DIRECTORY + stem + "_CONFIRMED.txt";
+            std::ofstream out(target + ".tmp", std::ios::binary);
+            out << confirmedText;
+            out.close();
+            std::error_code ec;
+            std::filesystem::rename(target + ".tmp", target, ec);
+        }
+
+        std::lock_guard<std::mutex> lock(confirmMutex);
+        if (!success) {
+            cascadeStats.failed++;
+            continue;
+        }
+        cascadeStats.confirms++;
+        if (replaced) cascadeStats.replaced++;
+        cascadeStats.confirmMsTotal += ms;
+        if (ms > cascadeStats.confirmMsMax) cascadeStats.confirmMsMax = ms;
+    }
+}
+
+void Transcriber::transcribeSegmentCascade(const std::string& audioFilePath, std::chrono::steady_clock::time_point detectedAt) {
+    std::string outputBase = getSegmentedAudioFile(audioFilePath);
+    bool success = runWhisper(draftModelPath, audioFilePath, outputBase, 0, false);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - detectedAt).count();
+
+    {
+        std::lock_guard<std::mutex> lock(confirmMutex);
+        if (success) {
+            cascadeStats.drafts++;
+            cascadeStats.draftMsTotal += ms;
+            if (ms > cascadeStats.draftMsMax) cascadeStats.draftMsMax = ms;
+        }
+
+        // A failed draft still gets confirmed, so the segment shows up eventually
+        confirmQueue.push_back({ audioFilePath, success ? readTranscript(outputBase + ".txt") : "", detectedAt });
+        while (confirmQueue.size() > CONFIRM_MAX_BACKLOG) {
+            confirmQueue.pop_front();
+            cascadeStats.skipped++;
+        }
+    }
+    confirmCondition.notify_one();
+}
+
+std::string Transcriber::readTranscript(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    const char* whitespace = " \t\r\n";
+    size_t first = text.find_first_not_of(whitespace);
+    if (first == std::string::npos) return "";
+    size_t last = text.find_last_not_of(whitespace);
+    return text.substr(first, last - first + 1);
+}
+
+bool Transcriber::runProcessWithWorkingDir(const std::string& command, const std::string& workingDir, bool lowPriority) {
     STARTUPINFOA si = { sizeof(si) };
     PROCESS_INFORMATION pi;
     char cmd[MAX_PATH * 4];
@@ -79,7 +224,8 @@ bool Transcriber::runProcessWithWorkingDir(const std::string& command, const std
         NULL,                   // default process security
         NULL,                   // default thread security
         FALSE,                  // don't inherit handles
-        CREATE_NO_WINDOW,       // run without showing a window
+        CREATE_NO_WINDOW |      // run without showing a window
+        (lowPriority ? BELOW_NORMAL_PRIORITY_CLASS : 0),
         NULL,                   // use parent's environment
         workingDir.c_str(),     // set working directory
         &si,                    // startup info
@@ -100,26 +246,41 @@ bool Transcriber::runProcessWithWorkingDir(const std::string& command, const std
 
 void Transcriber::transcribeFile(const std::string& audioFilePath) {
     std::string outputBase;
+    bool isFullAudio = false;
 
     if (audioFilePath.find(SEGMENTED_AUDIO_DIRECTORY) != std::string::npos) {
         outputBase = getSegmentedAudioFile(audioFilePath);
     }
     else if (audioFilePath.find(FULL_AUDIO_DIRECTORY) != std::string::npos) {
         outputBase = getFullAudioFile(audioFilePath);
+        isFullAudio = true;
     }
     else {
         return;
     }
 
+    if (transcribeFile(audioFilePath, outputBase) && isFullAudio) {
+        TranscriptIndex::addTranscript(outputBase + ".srt");
+    }
+}
+
+bool Transcriber::transcribeFile(const std::string& audioFilePath, const std::string& outputBase, int threads) {
+    return runWhisper(modelPath, audioFilePath, outputBase, threads, false);
+}
+
+bool Transcriber::runWhisper(const std::string& model, const std::string& audioFilePath, const std::string& outputBase, int threads, bool lowPriority) {
     std::string command = "\"" + whisperExe + "\"" +
-        " -m \"" + modelPath + "\"" +
+        " -m \"" + model + "\"" +
         " -f \"" + audioFilePath + "\"" +
         " -of \"" + outputBase + "\"" +
         " --language ja" + // TODO: Add language selector
         " --output-txt --output-srt";
+    if (threads > 0) {
+        command += " -t " + std::to_string(threads);
+    }
 
     std::string whisperDir = exeDir + "external\\whisper.cpp\\";
-    runProcessWithWorkingDir(command, whisperDir);
+    return runProcessWithWorkingDir(command, whisperDir, lowPriority);
 }
 
 std::string Transcriber::getSegmentedAudioFile(const std::string& audioFilePath) {
@@ -4,21 +4,72 @@
 #include <thread>
 #include <atomic>
 #include <set>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 class Transcriber {
 public:
     static void startTranscription();
     static void stopTranscription();
 
+    static bool transcribeFile(const std::string& audioFilePath, const std::string& outputBase, int threads = 0);
+
+    /**
+    * @brief Enables the draft/confirm cascade for live segments, call before startTranscription()
+    * @param draftModel Small or quantized model used for the immediate draft
+    *
+    * Each segment is transcribed by the draft model right away. The regular model then re-decodes it
+    * at lower priority and writes "<segment>_CONFIRMED.txt" next to the draft only if the text changed;
+    * an empty file means the draft should be dropped.
+    * Confirm jobs that fall too far behind are dropped.
+    */
+    static void enableCascade(const std::string& draftModel);
+    static void printCascadeStats();
+
 private:
+    static constexpr int CONFIRM_MAX_LAG_MS = 8000;
+    static constexpr size_t CONFIRM_MAX_BACKLOG = 4;
+
+    struct ConfirmJob {
+        std::string audioFilePath;
+        std::string draftText;
+        std::chrono::steady_clock::time_point detectedAt;
+    };
+
+    struct CascadeStats {
+        int drafts = 0;
+        int confirms = 0;
+        int replaced = 0;
+        int skipped = 0;   // Dropped for lag or backlog
+        int failed = 0;    // whisper-cli run failed
+        double draftMsTotal = 0.0;
+        double draftMsMax = 0.0;
+        double confirmMsTotal = 0.0;
+        double confirmMsMax = 0.0;
+    };
+
     static void monitorAudioDirectory();
+    static void confirmLoop();
 
-    static bool runProcessWithWorkingDir(const std::string& command, const std::string& workingDir);
+    static bool runProcessWithWorkingDir(const std::string& command, const std::string& workingDir, bool lowPriority = false);
+    static bool runWhisper(const std::string& model, const std::string& audioFilePath, const std::string& outputBase, int threads, bool lowPriority);
     static void transcribeFile(const std::string& audioFilePath);
+    static void transcribeSegmentCascade(const std::string& audioFilePath, std::chrono::steady_clock::time_point detectedAt);
+    static std::string readTranscript(const std::string& path);
     static std::string getSegmentedAudioFile(const std::string& audioFilePath);
     static std::string getFullAudioFile(const std::string& audioFilePath);
 
     static std::atomic<bool> running;
     static std::thread monitorThread;
     static std::set<std::string> processedFiles;
-};
\ No newline at end of file
+
+    static std::atomic<bool> cascadeEnabled;
+    static std::string draftModelPath;
+    static std::thread confirmThread;
+    static std::deque<ConfirmJob> confirmQueue;
+    static std::mutex confirmMutex;
+    static std::condition_variable confirmCondition;
+    static CascadeStats cascadeStats;
+};
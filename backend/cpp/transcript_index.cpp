@@ -0,0 +1,1087 @@
+#include "transcript_index.h"
+
+#define NOMINMAX
+#include <windows.h>
+
+#include "external/json.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+#define INDEX_DIRECTORY std::string("C:\\live-furigana\\Saved\\Index\\")
+#define INDEX_BENCHMARK_DIRECTORY std::string("C:\\live-furigana\\Cache\\IndexBenchmark\\")
+#define FULL_TRANSCRIPT_DIRECTORY std::string("C:\\live-furigana\\Saved\\Transcripts\\")
+
+namespace {
+    constexpr char SEGMENT_MAGIC[4] = { 'T', 'I', 'D', 'X' };
+    constexpr uint32_t SEGMENT_VERSION = 3;
+    constexpr const char* SEGMENT_EXTENSION = ".tidx";
+    constexpr const char* LOCK_FILE_NAME = "index.lock";
+    constexpr int MERGE_FACTOR = 4;                 // Segments of one size tier merged together
+    constexpr uint64_t TIER_BASE_BYTES = 64 * 1024;
+    constexpr int RESCAN_INTERVAL_SECONDS = 5;
+
+    // On-disk layout, all little-endian: Header, BigramEntry[], SessionEntry[], CueEntry[], postings, text
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t sessionCount;
+        uint32_t cueCount;
+        uint64_t bigramCount;
+        uint64_t bigramsOffset;
+        uint64_t sessionsOffset;
+        uint64_t cuesOffset;
+        uint64_t postingsOffset;
+        uint64_t textOffset;
+        uint64_t textSize;
+    };
+
+    struct BigramEntry {
+        uint64_t key;                               // (first code point << 32) | second code point
+        uint64_t postingsOffset;                    // Varint delta-coded cue ids, relative to postings
+        uint32_t count;
+        uint32_t reserved;
+    };
+
+    struct SessionEntry {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint64_t sourceSize;                        // Size and content hash of the .srt the session was built from,
+        uint64_t sourceHash;                        // so a transcript gets indexed again only if its text changed
+    };
+
+    struct CueEntry {
+        uint32_t session;
+        uint32_t startMs;
+        uint32_t endMs;
+        uint32_t textOffset;
+        uint32_t textLength;
+    };
+
+    struct Cue {
+        uint32_t startMs;
+        uint32_t endMs;
+        std::string text;
+    };
+
+    struct SourceStamp {
+        uint64_t size = 0;
+        uint64_t hash = 0;
+
+        bool operator==(const SourceStamp& other) const {
+            return size == other.size && hash == other.hash;
+        }
+    };
+
+    struct Session {
+        std::string name;
+        std::vector<Cue> cues;
+        SourceStamp source;
+    };
+
+    // Keyed on content rather than write time: live transcription regenerates every .srt on each launch,
+    // and an identical rewrite must not re-index the whole history
+    SourceStamp sourceStamp(const std::filesystem::path& path) {
+        SourceStamp stamp;
+        std::ifstream in(path, std::ios::binary);
+        uint64_t hash = 14695981039346656037ull;    // FNV-1a 64
+        char buffer[64 * 1024];
+        while (in) {
+            in.read(buffer, sizeof(buffer));
+            std::streamsize count = in.gcount();
+            for (std::streamsize i = 0; i < count; ++i) {
+                hash ^= static_cast<unsigned char>(buffer[i]);
+                hash *= 1099511628211ull;
+            }
+            stamp.size += static_cast<uint64_t>(count);
+        }
+        stamp.hash = hash;
+        return stamp;
+    }
+
+    // Orders runs of digits by value, so RECORDING_2 comes before RECORDING_10
+    bool naturalLess(const std::string& a, const std::string& b) {
+        size_t i = 0, j = 0;
+        while (i < a.size() && j < b.size()) {
+            const bool digitA = std::isdigit(static_cast<unsigned char>(a[i])) != 0;
+            const bool digitB = std::isdigit(static_cast<unsigned char>(b[j])) != 0;
+            if (digitA && digitB) {
+                size_t endA = i, endB = j;
+                while (endA < a.size() && std::isdigit(static_cast<unsigned char>(a[endA]))) endA++;
+                while (endB < b.size() && std::isdigit(static_cast<unsigned char>(b[endB]))) endB++;
+                size_t startA = i, startB = j;
+                while (startA + 1 < endA && a[startA] == '0') startA++;
+                while (startB + 1 < endB && b[startB] == '0') startB++;
+
+                const size_t lengthA = endA - startA, lengthB = endB - startB;
+                if (lengthA != lengthB) return lengthA < lengthB;
+                const int order = a.compare(startA, lengthA, b, startB, lengthB);
+                if (order != 0) return order < 0;
+                i = endA;
+                j = endB;
+            }
+            else {
+                if (a[i] != b[j]) return static_cast<unsigned char>(a[i]) < static_cast<unsigned char>(b[j]);
+                i++;
+                j++;
+            }
+        }
+        return a.size() - i < b.size() - j;
+    }
+
+    std::u32string decodeUtf8(const std::string& text) {
+        std::u32string out;
+        out.reserve(text.size());
+        size_t i = 0;
+        while (i < text.size()) {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            int extra = c < 0x80 ? 0 : (c >> 5) == 0x6 ? 1 : (c >> 4) == 0xE ? 2 : (c >> 3) == 0x1E ? 3 : -1;
+            if (extra < 0 || i + extra >= text.size()) {
+                out.push_back(0xFFFD);
+                i++;
+                continue;
+            }
+            char32_t cp = extra == 0 ? c : extra == 1 ? (c & 0x1F) : extra == 2 ? (c & 0x0F) : (c & 0x07);
+            bool valid = true;
+            for (int k = 1; k <= extra; ++k) {
+                unsigned char cc = static_cast<unsigned char>(text[i + k]);
+                if ((cc >> 6) != 0x2) {
+                    valid = false;
+                    break;
+                }
+                cp = (cp << 6) | (cc & 0x3F);
+            }
+            if (!valid) {
+                out.push_back(0xFFFD);
+                i++;
+                continue;
+            }
+            out.push_back(cp);
+            i += extra + 1;
+        }
+        return out;
+    }
+
+    std::string encodeUtf8(char32_t cp) {
+        std::string out;
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        }
+        else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        else {
+            out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        return out;
+    }
+
+    // Folds what should match regardless of how whisper happened to write it; whitespace is dropped
+    std::u32string normalize(const std::string& text) {
+        std::u32string out;
+        for (char32_t cp : decodeUtf8(text)) {
+            if (cp == U' ' || cp == U'\t' || cp == U'\r' || cp == U'\n' || cp == 0x3000) continue;
+            if (cp >= 0xFF01 && cp <= 0xFF5E) cp -= 0xFEE0;     // Fullwidth ASCII
+            if (cp >= U'A' && cp <= U'Z') cp += U'a' - U'A';
+            out.push_back(cp);
+        }
+        return out;
+    }
+
+    std::vector<uint64_t> bigramKeys(const std::u32string& text) {
+        std::vector<uint64_t> keys;
+        for (size_t i = 0; i + 1 < text.size(); ++i) {
+            keys.push_back((static_cast<uint64_t>(text[i]) << 32) | text[i + 1]);
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        return keys;
+    }
+
+    void writeVarint(std::string& out, uint32_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    // False if the varint runs past end or does not fit 32 bits
+    bool readVarint(const uint8_t*& p, const uint8_t* end, uint32_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 35 && p < end; shift += 7) {
+            uint8_t byte = *p++;
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    uint32_t parseSrtTime(const std::string& s) {
+        int h = 0, m = 0, sec = 0, ms = 0;
+        if (sscanf_s(s.c_str(), "%d:%d:%d,%d", &h, &m, &sec, &ms) != 4) return 0;
+        return static_cast<uint32_t>(((h * 60 + m) * 60 + sec) * 1000 + ms);
+    }
+
+    std::vector<Cue> parseSrt(const std::string& path) {
+        std::vector<Cue> cues;
+        std::ifstream in(path, std::ios::binary);
+        std::string line;
+        Cue current{};
+        bool inCue = false;
+
+        auto finish = [&]() {
+            if (inCue && !current.text.empty()) cues.push_back(current);
+            current = Cue{};
+            inCue = false;
+        };
+
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            size_t arrow = line.find(" --> ");
+            if (arrow != std::string::npos) {
+                finish();
+                current.startMs = parseSrtTime(line.substr(0, arrow));
+                current.endMs = parseSrtTime(line.substr(arrow + 5));
+                inCue = true;
+            }
+            else if (line.empty()) {
+                finish();
+            }
+            else if (inCue) {
+                if (!current.text.empty()) current.text += " ";
+                current.text += line;
+            }
+        }
+        finish();
+        return cues;
+    }
+
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile() { close(); }
+
+        bool open(const std::string& path) {
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) return false;
+
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(Header))) return false;
+            size = static_cast<size_t>(fileSize.QuadPart);
+
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping == nullptr) return false;
+            data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            return data != nullptr;
+        }
+
+        void close() {
+            if (data) UnmapViewOfFile(data);
+            if (mapping) CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+            data = nullptr;
+            mapping = nullptr;
+            file = INVALID_HANDLE_VALUE;
+        }
+
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+
+    private:
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+    };
+
+    // Held by the one process allowed to write the index. The file is opened without sharing, so any other
+    // process fails to open it, and Windows releases it when the process exits, however it exits.
+    class WriterLock {
+    public:
+        WriterLock() = default;
+        WriterLock(const WriterLock&) = delete;
+        WriterLock& operator=(const WriterLock&) = delete;
+        ~WriterLock() { release(); }
+
+        bool acquire(const std::string& path) {
+            if (held()) return true;
+            file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+            return held();
+        }
+
+        void release() {
+            if (held()) CloseHandle(file);
+            file = INVALID_HANDLE_VALUE;
+        }
+
+        bool held() const {
+            return file != INVALID_HANDLE_VALUE;
+        }
+
+    private:
+        HANDLE file = INVALID_HANDLE_VALUE;
+    };
+
+    struct Segment {
+        std::string path;
+        uint64_t generation = 0;
+        MappedFile file;
+        const Header* header = nullptr;
+        const BigramEntry* bigrams = nullptr;
+        const SessionEntry* sessions = nullptr;
+        const CueEntry* cues = nullptr;
+        const uint8_t* postings = nullptr;
+        const char* text = nullptr;
+
+        std::vector<char> live;                     // Per session: not superseded by a newer segment
+        std::vector<uint32_t> rank;                 // Per session: position in result order
+
+        // Every section and every entry that points into another section is checked against the file,
+        // so a truncated or corrupt segment is rejected here instead of being read out of bounds later
+        bool open() {
+            if (!file.open(path)) return false;
+            header = reinterpret_cast<const Header*>(file.data);
+            if (std::memcmp(header->magic, SEGMENT_MAGIC, 4) != 0 || header->version != SEGMENT_VERSION) return false;
+
+            if (!sectionFits(header->bigramsOffset, header->bigramCount, sizeof(BigramEntry), alignof(BigramEntry)) ||
+                !sectionFits(header->sessionsOffset, header->sessionCount, sizeof(SessionEntry), alignof(SessionEntry)) ||
+                !sectionFits(header->cuesOffset, header->cueCount, sizeof(CueEntry), alignof(CueEntry)) ||
+                !sectionFits(header->postingsOffset, header->textOffset - header->postingsOffset, 1, 1) ||
+                !sectionFits(header->textOffset, header->textSize, 1, 1) ||
+                header->textOffset < header->postingsOffset) return false;
+
+            bigrams = reinterpret_cast<const BigramEntry*>(file.data + header->bigramsOffset);
+            sessions = reinterpret_cast<const SessionEntry*>(file.data + header->sessionsOffset);
+            cues = reinterpret_cast<const CueEntry*>(file.data + header->cuesOffset);
+            postings = file.data + header->postingsOffset;
+            text = reinterpret_cast<const char*>(file.data + header->textOffset);
+
+            const uint64_t postingsSize = header->textOffset - header->postingsOffset;
+            for (uint64_t b = 0; b < header->bigramCount; ++b) {
+                if (bigrams[b].postingsOffset >= postingsSize && bigrams[b].count > 0) return false;
+                if (b > 0 && bigrams[b].key <= bigrams[b - 1].key) return false;
+            }
+            for (uint32_t s = 0; s < header->sessionCount; ++s) {
+                if (!rangeFits(sessions[s].nameOffset, sessions[s].nameLength, header->textSize)) return false;
+            }
+            for (uint32_t c = 0; c < header->cueCount; ++c) {
+                if (cues[c].session >= header->sessionCount || !rangeFits(cues[c].textOffset, cues[c].textLength, header->textSize)) return false;
+            }
+
+            live.assign(header->sessionCount, 0);
+            rank.assign(header->sessionCount, 0);
+            return true;
+        }
+
+        bool sectionFits(uint64_t offset, uint64_t count, size_t entrySize, size_t alignment) const {
+            return offset >= sizeof(Header) && offset <= file.size && offset % alignment == 0 &&
+                count <= (file.size - offset) / entrySize;
+        }
+
+        static bool rangeFits(uint64_t offset, uint64_t length, uint64_t size) {
+            return offset <= size && length <= size - offset;
+        }
+
+        // Written by an older build; its sessions are re-added from the transcripts
+        bool outdated() const {
+            return header && std::memcmp(header->magic, SEGMENT_MAGIC, 4) == 0 && header->version < SEGMENT_VERSION;
+        }
+
+        std::string sessionName(uint32_t session) const {
+            return std::string(text + sessions[session].nameOffset, sessions[session].nameLength);
+        }
+
+        SourceStamp sessionSource(uint32_t session) const {
+            return { sessions[session].sourceSize, sessions[session].sourceHash };
+        }
+
+        std::string cueText(uint32_t cue) const {
+            return std::string(text + cues[cue].textOffset, cues[cue].textLength);
+        }
+
+        std::vector<uint32_t> postingList(uint64_t key) const {
+            const BigramEntry* end = bigrams + header->bigramCount;
+            const BigramEntry* it = std::lower_bound(bigrams, end, key,
+                [](const BigramEntry& entry, uint64_t k) { return entry.key < k; });
+            std::vector<uint32_t> list;
+            if (it == end || it->key != key) return list;
+
+            // Varints are only validated while decoding, so a corrupt list ends early rather than reading past it
+            list.reserve(std::min<uint64_t>(it->count, header->cueCount));
+            const uint8_t* p = postings + it->postingsOffset;
+            const uint8_t* postingsEnd = reinterpret_cast<const uint8_t*>(text);
+            uint64_t cue = 0;
+            for (uint32_t i = 0; i < it->count; ++i) {
+                uint32_t delta = 0;
+                if (!readVarint(p, postingsEnd, delta)) break;
+                cue += delta;
+                if (cue >= header->cueCount || (i > 0 && delta == 0)) break;
+                list.push_back(static_cast<uint32_t>(cue));
+            }
+            return list;
+        }
+
+        std::vector<Session> readSessions() const {
+            std::vector<Session> out(header->sessionCount);
+            for (uint32_t s = 0; s < header->sessionCount; ++s) {
+                out[s].name = sessionName(s);
+                out[s].source = sessionSource(s);
+            }
+            for (uint32_t c = 0; c < header->cueCount; ++c) {
+                out[cues[c].session].cues.push_back({ cues[c].startMs, cues[c].endMs, cueText(c) });
+            }
+            return out;
+        }
+
+        int tier() const {
+            int t = 0;
+            for (uint64_t size = file.size / TIER_BASE_BYTES; size >= MERGE_FACTOR; size /= MERGE_FACTOR) t++;
+            return t;
+        }
+    };
+
+    bool writeSegment(const std::vector<Session>& sessions, const std::string& path) {
+        std::string text;
+        std::vector<SessionEntry> sessionEntries;
+        std::vector<CueEntry> cueEntries;
+        std::unordered_map<uint64_t, std::vector<uint32_t>> postingMap;
+
+        for (uint32_t s = 0; s < sessions.size(); ++s) {
+            sessionEntries.push_back({ static_cast<uint32_t>(text.size()), static_cast<uint32_t>(sessions[s].name.size()),
+                sessions[s].source.size, sessions[s].source.hash });
+            text += sessions[s].name;
+
+            for (const auto& cue : sessions[s].cues) {
+                uint32_t cueId = static_cast<uint32_t>(cueEntries.size());
+                cueEntries.push_back({ s, cue.startMs, cue.endMs, static_cast<uint32_t>(text.size()), static_cast<uint32_t>(cue.text.size()) });
+                text += cue.text;
+                for (uint64_t key : bigramKeys(normalize(cue.text))) {
+                    postingMap[key].push_back(cueId);
+                }
+            }
+        }
+
+        std::vector<uint64_t> keys;
+        keys.reserve(postingMap.size());
+        for (const auto& [key, list] : postingMap) keys.push_back(key);
+        std::sort(keys.begin(), keys.end());
+
+        std::vector<BigramEntry> bigramEntries;
+        bigramEntries.reserve(keys.size());
+        std::string postings;
+        for (uint64_t key : keys) {
+            const auto& list = postingMap[key];
+            bigramEntries.push_back({ key, postings.size(), static_cast<uint32_t>(list.size()), 0 });
+            uint32_t previous = 0;
+            for (uint32_t cue : list) {
+                writeVarint(postings, cue - previous);
+                previous = cue;
+            }
+        }
+
+        Header header{};
+        std::memcpy(header.magic, SEGMENT_MAGIC, 4);
+        header.version = SEGMENT_VERSION;
+        header.sessionCount = static_cast<uint32_t>(sessionEntries.size());
+        header.cueCount = static_cast<uint32_t>(cueEntries.size());
+        header.bigramCount = bigramEntries.size();
+        header.bigramsOffset = sizeof(Header);
+        header.sessionsOffset = header.bigramsOffset + bigramEntries.size() * sizeof(BigramEntry);
+        header.cuesOffset = header.sessionsOffset + sessionEntries.size() * sizeof(SessionEntry);
+        header.postingsOffset = header.cuesOffset + cueEntries.size() * sizeof(CueEntry);
+        header.textOffset = header.postingsOffset + postings.size();
+        header.textSize = text.size();
+
+        // Written aside and renamed so a crash never leaves a half-written segment behind
+        std::string tmpPath = path + ".tmp";
+        std::ofstream out(tmpPath, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(bigramEntries.data()), bigramEntries.size() * sizeof(BigramEntry));
+        out.write(reinterpret_cast<const char*>(sessionEntries.data()), sessionEntries.size() * sizeof(SessionEntry));
+        out.write(reinterpret_cast<const char*>(cueEntries.data()), cueEntries.size() * sizeof(CueEntry));
+        out.write(postings.data(), postings.size());
+        out.write(text.data(), text.size());
+        out.close();
+        if (!out) return false;
+
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, path, ec);
+        return !ec;
+    }
+
+    struct Hit {
+        const Segment* segment;
+        uint32_t cue;
+        uint32_t rank;
+        uint32_t startMs;
+    };
+
+    class IndexStore {
+    public:
+        explicit IndexStore(const std::string& directory) : directory(directory) {}
+
+        // Only a writer cleans up and adds segments; readers just map what the writer has renamed into place
+        void open(bool writer) {
+            segments.clear();
+            current.clear();
+            nextGeneration = 1;
+            writable = writer;
+
+            std::filesystem::create_directories(directory);
+            for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+                if (!entry.is_regular_file()) continue;
+                if (entry.path().extension() == ".tmp") {
+                    std::error_code ec;
+                    if (writable) std::filesystem::remove(entry.path(), ec);
+                    continue;
+                }
+                std::string stem = entry.path().stem().string();
+                if (entry.path().extension() != SEGMENT_EXTENSION || stem.empty() ||
+                    !std::all_of(stem.begin(), stem.end(), [](unsigned char c) { return std::isdigit(c); })) continue;
+
+                auto segment = std::make_unique<Segment>();
+                segment->path = entry.path().string();
+                segment->generation = std::stoull(stem);
+                nextGeneration = std::max(nextGeneration, segment->generation + 1);
+                if (!segment->open()) {
+                    if (!writable) continue;
+                    if (segment->outdated()) {
+                        segment->file.close();
+                        std::error_code ec;
+                        std::filesystem::remove(segment->path, ec);
+                    }
+                    else {
+                        std::cout << "Skipping unreadable index segment " << segment->path << std::endl;
+                    }
+                    continue;
+                }
+                segments.push_back(std::move(segment));
+            }
+
+            // Oldest first, so each session ends up current in the newest segment that holds it
+            std::sort(segments.begin(), segments.end(), [](const auto& a, const auto& b) { return a->generation < b->generation; });
+            for (const auto& segment : segments) {
+                for (uint32_t s = 0; s < segment->header->sessionCount; ++s) {
+                    markCurrent(segment.get(), s);
+                }
+            }
+
+            // Segments with nothing current are leftovers of a merge that was interrupted before cleanup
+            std::vector<std::string> stalePaths;
+            for (size_t i = segments.size(); i-- > 0;) {
+                if (std::none_of(segments[i]->live.begin(), segments[i]->live.end(), [](char live) { return live != 0; })) {
+                    stalePaths.push_back(segments[i]->path);
+                    segments.erase(segments.begin() + i);
+                }
+            }
+            if (writable) removeFiles(stalePaths);
+            rankSessions();
+        }
+
+        bool isWritable() const {
+            return writable;
+        }
+
+        // True when the session is indexed from a source with this size and content
+        bool isCurrent(const std::string& session, const SourceStamp& source) const {
+            auto it = current.find(session);
+            return it != current.end() && it->second.source == source;
+        }
+
+        void add(const Session& session) {
+            addAll({ session });
+        }
+
+        // All sessions go into one segment, so a large backlog costs one write and one merge pass
+        void addAll(const std::vector<Session>& sessions) {
+            if (!writable) return;
+            std::vector<Session> pending;
+            for (const auto& session : sessions) {
+                if (!isCurrent(session.name, session.source)) pending.push_back(session);
+            }
+            if (pending.empty()) return;
+
+            Segment* segment = addSegment(pending);
+            if (!segment) return;
+            for (uint32_t s = 0; s < segment->header->sessionCount; ++s) {
+                markCurrent(segment, s);
+            }
+            mergeTiers();
+            rankSessions();
+        }
+
+        std::vector<TranscriptIndex::Match> search(const std::string& query, size_t limit, size_t& total) const {
+            std::vector<TranscriptIndex::Match> matches;
+            total = 0;
+            std::u32string needle = normalize(query);
+            if (needle.empty()) return matches;
+            std::vector<uint64_t> keys = bigramKeys(needle);
+
+            // Raw cue text containing the folded phrase is a match without folding the cue:
+            // UTF-8 can't match mid-character, and folded characters fold to themselves
+            std::string needleUtf8;
+            for (char32_t cp : needle) needleUtf8 += encodeUtf8(cp);
+
+            // Every segment is searched in full, so what is returned does not depend on segment order
+            std::vector<Hit> hits;
+            for (const auto& segment : segments) {
+                std::vector<uint32_t> candidates;
+                if (keys.empty()) {
+                    // Single character, nothing to look up: scan the segment
+                    candidates.resize(segment->header->cueCount);
+                    for (uint32_t c = 0; c < candidates.size(); ++c) candidates[c] = c;
+                }
+                else {
+                    std::vector<std::vector<uint32_t>> lists;
+                    for (uint64_t key : keys) {
+                        lists.push_back(segment->postingList(key));
+                        if (lists.back().empty()) break;
+                    }
+                    if (lists.back().empty()) continue;
+
+                    std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) { return a.size() < b.size(); });
+                    candidates = lists[0];
+                    for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+                        std::vector<uint32_t> merged;
+                        std::set_intersection(candidates.begin(), candidates.end(), lists[i].begin(), lists[i].end(), std::back_inserter(merged));
+                        candidates.swap(merged);
+                    }
+                }
+
+                // Bigrams can all be present without forming the phrase, so confirm each hit.
+                // A two-character phrase is its own bigram, so its posting list is already exact.
+                const bool exact = needle.size() == 2;
+                for (uint32_t cue : candidates) {
+                    const CueEntry& entry = segment->cues[cue];
+                    if (!segment->live[entry.session]) continue;
+
+                    std::string_view raw(segment->text + entry.textOffset, entry.textLength);
+                    if (!exact && raw.find(needleUtf8) == std::string_view::npos) {
+                        std::u32string haystack = normalize(std::string(raw));
+                        if (std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end()) == haystack.end()) continue;
+                    }
+                    hits.push_back({ segment.get(), cue, segment->rank[entry.session], entry.startMs });
+                }
+            }
+
+            // Recording order, then time within the recording
+            total = hits.size();
+            auto order = [](const Hit& a, const Hit& b) {
+                return a.rank != b.rank ? a.rank < b.rank : a.startMs < b.startMs;
+            };
+            if (hits.size() > limit) {
+                std::partial_sort(hits.begin(), hits.begin() + limit, hits.end(), order);
+                hits.resize(limit);
+            }
+            else {
+                std::sort(hits.begin(), hits.end(), order);
+            }
+
+            matches.reserve(hits.size());
+            for (const Hit& hit : hits) {
+                const CueEntry& entry = hit.segment->cues[hit.cue];
+                matches.push_back({ hit.segment->sessionName(entry.session), entry.startMs, entry.endMs, hit.segment->cueText(hit.cue) });
+            }
+            return matches;
+        }
+
+        uint64_t sizeBytes() const {
+            uint64_t total = 0;
+            for (const auto& segment : segments) total += segment->file.size;
+            return total;
+        }
+
+        size_t segmentCount() const {
+            return segments.size();
+        }
+
+        void close() {
+            current.clear();
+            segments.clear();
+            writable = false;
+        }
+
+    private:
+        struct SessionRef {
+            Segment* segment;
+            uint32_t session;
+            SourceStamp source;
+        };
+
+        std::string directory;
+        std::vector<std::unique_ptr<Segment>> segments;
+        std::unordered_map<std::string, SessionRef> current;
+        uint64_t nextGeneration = 1;
+        bool writable = false;
+
+        Segment* addSegment(const std::vector<Session>& sessions) {
+            std::ostringstream oss;
+            oss << directory << std::setw(12) << std::setfill('0') << nextGeneration << SEGMENT_EXTENSION;
+
+            auto segment = std::make_unique<Segment>();
+            segment->path = oss.str();
+            segment->generation = nextGeneration;
+            if (!writeSegment(sessions, segment->path) || !segment->open()) {
+                std::cout << "Failed to write index segment " << segment->path << std::endl;
+                return nullptr;
+            }
+            nextGeneration++;
+            segments.push_back(std::move(segment));
+            return segments.back().get();
+        }
+
+        // The copy in the newest generation wins; older copies stay on disk until a merge drops them
+        void markCurrent(Segment* segment, uint32_t session) {
+            std::string name = segment->sessionName(session);
+            auto it = current.find(name);
+            if (it != current.end()) {
+                if (it->second.segment->generation > segment->generation) {
+                    segment->live[session] = 0;
+                    return;
+                }
+                it->second.segment->live[it->second.session] = 0;
+            }
+            segment->live[session] = 1;
+            current[name] = { segment, session, segment->sessionSource(session) };
+        }
+
+        void rankSessions() {
+            std::vector<const std::pair<const std::string, SessionRef>*> ordered;
+            ordered.reserve(current.size());
+            for (const auto& entry : current) ordered.push_back(&entry);
+            std::sort(ordered.begin(), ordered.end(), [](const auto* a, const auto* b) { return naturalLess(a->first, b->first); });
+            for (uint32_t i = 0; i < ordered.size(); ++i) {
+                ordered[i]->second.segment->rank[ordered[i]->second.session] = i;
+            }
+        }
+
+        // Size-tiered merging keeps the segment count logarithmic in the corpus size
+        void mergeTiers() {
+            while (true) {
+                std::unordered_map<int, std::vector<size_t>> tiers;
+                for (size_t i = 0; i < segments.size(); ++i) {
+                    tiers[segments[i]->tier()].push_back(i);
+                }
+
+                const std::vector<size_t>* full = nullptr;
+                for (const auto& [tier, members] : tiers) {
+                    if (members.size() >= MERGE_FACTOR) {
+                        full = &members;
+                        break;
+                    }
+                }
+                if (!full) return;
+
+                // Superseded sessions are dropped here. The merged segment gets the newest generation,
+                // so a crash before the old files are removed leaves nothing current in them.
+                std::vector<Session> merged;
+                for (size_t i : *full) {
+                    std::vector<Session> sessions = segments[i]->readSessions();
+                    for (uint32_t s = 0; s < sessions.size(); ++s) {
+                        if (segments[i]->live[s]) merged.push_back(std::move(sessions[s]));
+                    }
+                }
+                if (!merged.empty()) {
+                    Segment* segment = addSegment(merged);
+                    if (!segment) return;
+                    for (uint32_t s = 0; s < segment->header->sessionCount; ++s) {
+                        markCurrent(segment, s);
+                    }
+                }
+
+                // Old segments must be unmapped before Windows lets them be deleted
+                std::vector<std::string> oldPaths;
+                std::vector<size_t> removed = *full;
+                std::sort(removed.rbegin(), removed.rend());
+                for (size_t i : removed) {
+                    oldPaths.push_back(segments[i]->path);
+                    segments.erase(segments.begin() + i);
+                }
+                removeFiles(oldPaths);
+            }
+        }
+
+        static void removeFiles(const std::vector<std::string>& paths) {
+            for (const auto& path : paths) {
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+            }
+        }
+    };
+
+    std::mutex indexMutex;
+    IndexStore store(INDEX_DIRECTORY);
+    WriterLock writerLock;
+    std::thread indexThread;
+    std::atomic<bool> stopping{ false };
+    std::condition_variable stopCondition;
+
+    // Hashes of unchanged files are reused between rescans; only the index thread touches this
+    struct CachedStamp {
+        uintmax_t size;
+        std::filesystem::file_time_type time;
+        SourceStamp stamp;
+    };
+    std::unordered_map<std::string, CachedStamp> stampCache;
+
+    // Hashing and parsing run without the lock, so searches are only held up while the segment is written
+    void catchUp() {
+        std::vector<Session> backlog;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(FULL_TRANSCRIPT_DIRECTORY, ec)) {
+            if (stopping) return;
+            if (!entry.is_regular_file() || entry.path().extension() != ".srt") continue;
+
+            std::error_code statError;
+            uintmax_t size = entry.file_size(statError);
+            auto time = entry.last_write_time(statError);
+            if (statError) continue;
+
+            std::string name = entry.path().stem().string();
+            auto cached = stampCache.find(name);
+            if (cached == stampCache.end() || cached->second.size != size || cached->second.time != time) {
+                cached = stampCache.insert_or_assign(name, CachedStamp{ size, time, sourceStamp(entry.path()) }).first;
+            }
+            SourceStamp source = cached->second.stamp;
+            {
+                std::lock_guard<std::mutex> lock(indexMutex);
+                if (store.isCurrent(name, source)) continue;
+            }
+            backlog.push_back({ name, parseSrt(entry.path().string()), source });
+        }
+        if (backlog.empty()) return;
+
+        std::lock_guard<std::mutex> lock(indexMutex);
+        store.addAll(backlog);
+        std::cout << "Indexed " << backlog.size() << " transcripts" << std::endl;
+    }
+
+    // Takes the writer lock if this process can get it, else reopens read-only to see the writer's new segments
+    void refresh() {
+        if (writerLock.held()) return;
+        bool writer = writerLock.acquire(INDEX_DIRECTORY + LOCK_FILE_NAME);
+        std::lock_guard<std::mutex> lock(indexMutex);
+        store.open(writer);
+    }
+
+    // Transcripts written by other processes, such as --ingest, are picked up here by whichever process holds the lock
+    void indexLoop() {
+        while (!stopping) {
+            refresh();
+            if (writerLock.held()) catchUp();
+
+            std::unique_lock<std::mutex> lock(indexMutex);
+            stopCondition.wait_for(lock, std::chrono::seconds(RESCAN_INTERVAL_SECONDS), [] { return stopping.load(); });
+        }
+    }
+
+    std::string formatTimestamp(uint32_t ms) {
+        std::ostringstream oss;
+        oss << std::setfill('0') << std::setw(2) << ms / 3600000 << ":"
+            << std::setw(2) << (ms / 60000) % 60 << ":"
+            << std::setw(2) << (ms / 1000) % 60 << ","
+            << std::setw(3) << ms % 1000;
+        return oss.str();
+    }
+}
+
+void TranscriptIndex::initialize() {
+    refresh();
+
+    // Catch up on transcripts written or rewritten while the index was not running, without holding up startup
+    stopping = false;
+    indexThread = std::thread(indexLoop);
+}
+
+void TranscriptIndex::openReadOnly() {
+    std::lock_guard<std::mutex> lock(indexMutex);
+    store.open(false);
+}
+
+void TranscriptIndex::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        stopping = true;
+    }
+    stopCondition.notify_all();
+    if (indexThread.joinable()) {
+        indexThread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(indexMutex);
+    store.close();
+    writerLock.release();
+}
+
+void TranscriptIndex::addTranscript(const std::string& srtPath) {
+    std::filesystem::path path(srtPath);
+    if (!std::filesystem::exists(path)) return;
+
+    // Another process owns the index; it picks the file up on its next rescan
+    {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        if (!store.isWritable()) return;
+    }
+
+    std::string name = path.stem().string();
+    SourceStamp source = sourceStamp(path);
+    std::lock_guard<std::mutex> lock(indexMutex);
+    if (!store.isCurrent(name, source)) {
+        store.add({ name, parseSrt(srtPath), source });
+    }
+}
+
+TranscriptIndex::SearchResult TranscriptIndex::search(const std::string& query, size_t limit) {
+    std::lock_guard<std::mutex> lock(indexMutex);
+    SearchResult result;
+    result.matches = store.search(query, limit, result.total);
+    return result;
+}
+
+std::string TranscriptIndex::searchJson(const std::string& query, size_t limit) {
+    auto start = std::chrono::steady_clock::now();
+    SearchResult result = search(query, limit);
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    nlohmann::json results = nlohmann::json::array();
+    for (const auto& match : result.matches) {
+        results.push_back({
+            { "session", match.session },
+            { "start", formatTimestamp(match.startMs) },
+            { "end", formatTimestamp(match.endMs) },
+            { "startMs", match.startMs },
+            { "endMs", match.endMs },
+            { "text", match.text }
+        });
+    }
+
+    nlohmann::json response = {
+        { "type", "search" },
+        { "query", query },
+        { "elapsedMs", elapsedMs },
+        { "total", result.total },
+        { "truncated", result.total > result.matches.size() },
+        { "results", results }
+    };
+    return response.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+void TranscriptIndex::runBenchmark(int hours) {
+    const int cuesPerHour = 1200;                   // One cue every ~3s
+    const int vocabularySize = 4000;
+    const int queryCount = 1000;
+
+    // Pseudo-Japanese vocabulary: 1-4 characters of kana and common-range kanji, drawn with a Zipf-like skew
+    std::mt19937 rng(42);
+    std::vector<std::string> vocabulary;
+    for (int w = 0; w < vocabularySize; ++w) {
+        std::string word;
+        int length = 1 + rng() % 4;
+        for (int c = 0; c < length; ++c) {
+            int kind = rng() % 3;
+            char32_t cp = kind == 0 ? 0x3041 + rng() % 83 : kind == 1 ? 0x30A1 + rng() % 86 : 0x4E00 + rng() % 2500;
+            word += encodeUtf8(cp);
+        }
+        vocabulary.push_back(word);
+    }
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    auto randomSentence = [&]() {
+        std::string sentence;
+        int words = 4 + rng() % 8;
+        for (int w = 0; w < words; ++w) {
+            double u = uniform(rng);
+            sentence += vocabulary[static_cast<size_t>(vocabularySize * u * u * u)];
+        }
+        return sentence;
+    };
+
+    std::filesystem::remove_all(INDEX_BENCHMARK_DIRECTORY);
+    IndexStore bench(INDEX_BENCHMARK_DIRECTORY);
+    bench.open(true);
+
+    // One session per hour of audio, added one at a time as live finalization would
+    std::vector<std::string> samples;
+    uint64_t characters = 0;
+    double generateSeconds = 0.0;
+    auto buildStart = std::chrono::steady_clock::now();
+    for (int h = 0; h < hours; ++h) {
+        auto generateStart = std::chrono::steady_clock::now();
+        Session session{ "BENCH_" + std::to_string(h + 1), {} };
+        for (int c = 0; c < cuesPerHour; ++c) {
+            std::string sentence = randomSentence();
+            characters += decodeUtf8(sentence).size();
+            session.cues.push_back({ static_cast<uint32_t>(c * 3000), static_cast<uint32_t>(c * 3000 + 2500), sentence });
+        }
+        if (samples.size() < static_cast<size_t>(queryCount)) {
+            samples.push_back(session.cues[rng() % session.cues.size()].text);
+        }
+        generateSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - generateStart).count();
+        bench.add(session);
+    }
+    double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - buildStart).count() - generateSeconds;
+
+    // Phrases of 2-6 characters cut from real cues, plus a few that should not occur
+    std::vector<std::string> queries;
+    for (int q = 0; q < queryCount; ++q) {
+        std::u32string text = decodeUtf8(samples[q % samples.size()]);
+        size_t length = std::min<size_t>(2 + rng() % 5, text.size());
+        size_t offset = rng() % (text.size() - length + 1);
+        std::string query;
+        for (size_t i = offset; i < offset + length; ++i) query += encodeUtf8(text[i]);
+        if (q % 10 == 0) query += encodeUtf8(0x9FA0);
+        queries.push_back(query);
+    }
+
+    std::vector<double> latencies;
+    size_t totalMatches = 0;
+    for (const auto& query : queries) {
+        auto start = std::chrono::steady_clock::now();
+        size_t total = 0;
+        bench.search(query, DEFAULT_LIMIT, total);
+        totalMatches += total;
+        latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    double sum = 0.0;
+    for (double l : latencies) sum += l;
+
+    std::cout << std::fixed << std::setprecision(2)
+        << "Index benchmark: " << hours << "h synthetic audio, " << static_cast<uint64_t>(hours) * cuesPerHour << " cues, "
+        << characters / 1000000.0 << "M characters" << std::endl
+        << "Build: " << buildSeconds << "s, " << bench.sizeBytes() / (1024.0 * 1024.0) << " MiB in "
+        << bench.segmentCount() << " segments" << std::endl
+        << "Query (" << queries.size() << "): avg " << sum / latencies.size() << "ms, p50 "
+        << latencies[latencies.size() / 2] << "ms, p99 " << latencies[latencies.size() * 99 / 100] << "ms, "
+        << totalMatches << " matches" << std::endl;
+
+    bench.close();
+    std::filesystem::remove_all(INDEX_BENCHMARK_DIRECTORY);
+}
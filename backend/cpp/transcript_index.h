@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class TranscriptIndex {
+public:
+    /**
+    * @brief Character-bigram inverted index over the .srt files in "C:\\live-furigana\\Saved\\Transcripts"
+    *
+    * Every finalized transcript is written as a small immutable segment file in "C:\\live-furigana\\Saved\\Index".
+    * Segments are memory-mapped for queries and merged in size tiers. A query is split into bigrams,
+    * their posting lists are intersected, and each candidate cue is checked for the exact phrase.
+    * Only the process holding "index.lock" in that directory writes segments; any other process reads them.
+    */
+    struct Match {
+        std::string session;
+        uint32_t startMs;
+        uint32_t endMs;
+        std::string text;
+    };
+
+    struct SearchResult {
+        std::vector<Match> matches;                 // At most limit, in recording order, then by time
+        size_t total = 0;                           // Every match, before the limit
+    };
+
+    /**
+    * @brief Opens the index and starts a background thread that indexes any transcripts it is missing
+    *
+    * The thread takes the writer lock when no other process holds it, and rescans the transcript directory
+    * every few seconds, so transcripts written by other processes are indexed too. Until it holds the lock,
+    * this process only reads the index.
+    */
+    static void initialize();
+
+    /**
+    * @brief Maps the index for searching only, without the writer lock or the background thread, for one-shot commands
+    */
+    static void openReadOnly();
+    static void shutdown();
+
+    /**
+    * @brief Indexes the transcript, or re-indexes it if its content changed since it was last indexed
+    *
+    * Does nothing unless this process holds the writer lock; the process that does picks the file up on its next rescan.
+    */
+    static void addTranscript(const std::string& srtPath);
+    static SearchResult search(const std::string& query, size_t limit = DEFAULT_LIMIT);
+
+    /**
+    * @brief Runs search() and returns the results as a single-line JSON object, with "total" and "truncated"
+    */
+    static std::string searchJson(const std::string& query, size_t limit = DEFAULT_LIMIT);
+
+    /**
+    * @brief Builds an index over a synthetic corpus in a scratch directory and prints build time, size and query latency
+    */
+    static void runBenchmark(int hours);
+
+private:
+    static constexpr size_t DEFAULT_LIMIT = 100;
+};
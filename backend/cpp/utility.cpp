@@ -12,8 +12,8 @@ void Utility::initializeDirectory() {
     }
 
     const std::vector<std::pair<std::string, std::vector<std::string>>> directoryGroups = {
-        {"Saved\\", {"Audios", "Transcripts", "Models"}},
-        {"Cache\\", {"Audios", "Transcripts"}}
+        {"Saved\\", {"Audios", "Transcripts", "Models", "Index"}},
+        {"Cache\\", {"Audios", "Transcripts", "Ingest", "Confirm"}}
     };
 
     for (const auto& [base, subdirs] : directoryGroups) {
@@ -0,0 +1,132 @@
+#include "vad_segmenter.h"
+
+#include <cmath>
+
+void VadSegmenter::reset(int sampleRate, int inputChannels) {
+    const int bytesPerSample = 2;
+    channels = inputChannels;
+    frameSamples = (sampleRate * VAD_FRAME_MS) / 1000;
+    frameBytes = frameSamples * bytesPerSample * channels;
+
+    vadBuffer.clear();
+    leftoverBytes.clear();
+    silenceFrames = 0;
+    speechFrames = 0;
+    hangoverFrames = 0;
+    inSpeech = false;
+
+    vadFrameIndex = 0;
+    segmentStartVadFrame = 0;
+
+    mel.reset(sampleRate, channels);
+}
+
+void VadSegmenter::push(const uint8_t* data, size_t size, const SegmentCallback& onSegment) {
+    mel.pushPcm(reinterpret_cast<const int16_t*>(data), size / (sizeof(int16_t) * channels));
+    leftoverBytes.insert(leftoverBytes.end(), data, data + size);
+    classifyFrames(false, onSegment);
+}
+
+void VadSegmenter::flush(const SegmentCallback& onSegment) {
+    // The stream ends here, so the last frames are judged with whatever mel frames exist
+    classifyFrames(true, onSegment);
+    if (!vadBuffer.empty()) {
+        emitSegment(vadFrameIndex, onSegment);
+    }
+}
+
+void VadSegmenter::classifyFrames(bool flushing, const SegmentCallback& onSegment) {
+    size_t offset = 0;
+    while (leftoverBytes.size() - offset >= frameBytes) {
+        // Hold the decision until both mel frames under this VAD frame exist (they need N_FFT / 2 samples
+        // of look-ahead plus the resampler latency), so the result does not depend on how the stream is chunked
+        const size_t melFramesNeeded = (vadFrameIndex + 1) * MEL_FRAMES_PER_VAD_FRAME;
+        const size_t pendingFrames = (leftoverBytes.size() - offset) / frameBytes;
+        if (!flushing && mel.totalFrames() < melFramesNeeded && pendingFrames <= VAD_MAX_PENDING_FRAMES) break;
+
+        classifyFrame(&leftoverBytes[offset], onSegment);
+        offset += frameBytes;
+    }
+    if (offset > 0) {
+        leftoverBytes.erase(leftoverBytes.begin(), leftoverBytes.begin() + offset);
+    }
+}
+
+void VadSegmenter::classifyFrame(const uint8_t* data, const SegmentCallback& onSegment) {
+    const int16_t* frame = reinterpret_cast<const int16_t*>(data);
+    float rms = frameRMS(frame, frameSamples * channels);
+    float bandPower = mel.speechBandPower(vadFrameIndex * MEL_FRAMES_PER_VAD_FRAME, (vadFrameIndex + 1) * MEL_FRAMES_PER_VAD_FRAME);
+
+    // Share of the full-band power, measured at the capture rate so content above 8 kHz counts too
+    float bandRatio = (bandPower >= 0.0f && rms > 0.0f) ? bandPower / (rms * rms) : 1.0f;
+
+    vadBuffer.insert(vadBuffer.end(), data, data + frameBytes);
+
+    if (rms > VAD_ENERGY_THRESHOLD && bandRatio >= VAD_SPEECH_BAND_RATIO) {
+        speechFrames++;
+        silenceFrames = 0;
+        inSpeech = true;
+        hangoverFrames = HANGOVER_MAX;
+    }
+    else {
+        if (inSpeech) silenceFrames++;
+        if (hangoverFrames > 0) {
+            hangoverFrames--;
+        }
+        if (inSpeech && silenceFrames >= VAD_MIN_SILENCE_FRAMES && speechFrames >= VAD_MIN_SPEECH_FRAMES && hangoverFrames == 0) {
+            emitSegment(vadFrameIndex + 1, onSegment);
+        }
+    }
+    vadFrameIndex++;
+}
+
+void VadSegmenter::emitSegment(size_t endVadFrame, const SegmentCallback& onSegment) {
+    float gain = 1.0f;
+    if (!vadBuffer.empty()) {
+        gain = normalizePeak(reinterpret_cast<int16_t*>(vadBuffer.data()), vadBuffer.size() / sizeof(int16_t));
+    }
+    onSegment(vadBuffer, gain, segmentStartVadFrame, endVadFrame, static_cast<size_t>(speechFrames));
+
+    vadBuffer.clear();
+    silenceFrames = 0;
+    speechFrames = 0;
+    inSpeech = false;
+    hangoverFrames = 0;
+    segmentStartVadFrame = endVadFrame;
+}
+
+float VadSegmenter::findPeakAbs(const int16_t* samples, size_t count) {
+    float peak = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        float absVal = std::abs(samples[i] / 32768.0f);
+        if (absVal > peak) peak = absVal;
+    }
+    return peak;
+}
+
+void VadSegmenter::applyGain(int16_t* samples, size_t count, float gain) {
+    for (size_t i = 0; i < count; ++i) {
+        float v = samples[i] * gain;
+        if (v > 32767.0f) v = 32767.0f;
+        if (v < -32768.0f) v = -32768.0f;
+        samples[i] = static_cast<int16_t>(std::round(v));
+    }
+}
+
+float VadSegmenter::normalizePeak(int16_t* samples, size_t count) {
+    float peak = findPeakAbs(samples, count);
+    float target = 0.98f;
+    float gain = (peak > 0.0001f && peak < target) ? (target / peak) : 1.0f;
+    if (gain <= 1.01f) return 1.0f;
+    applyGain(samples, count, gain);
+    return gain;
+}
+
+float VadSegmenter::frameRMS(const int16_t* samples, size_t count) {
+    double sum = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double v = samples[i] / 32768.0;
+        sum += v * v;
+    }
+    return static_cast<float>(sqrt(sum / count));
+}
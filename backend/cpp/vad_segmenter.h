@@ -0,0 +1,61 @@
+#pragma once
+
+#include "mel_frontend.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class VadSegmenter {
+public:
+    /**
+    * @brief Splits an interleaved 16-bit PCM stream into speech segments
+    *
+    * Shared by live capture and offline ingestion. A frame counts as speech when it is loud enough
+    * and enough of its energy sits in the speech band of the mel frontend, which runs on the same stream.
+    * Each finished segment is peak-normalized and handed to the callback together with the applied gain,
+    * its [start, end) range in VAD frames and how many of those frames were judged to be speech.
+    */
+    using SegmentCallback = std::function<void(std::vector<uint8_t>& segment, float gain, size_t startVadFrame, size_t endVadFrame, size_t speechVadFrames)>;
+
+    static constexpr int VAD_FRAME_MS = 20;
+    static constexpr int MEL_FRAMES_PER_VAD_FRAME = VAD_FRAME_MS / 10;
+
+    void reset(int sampleRate, int channels);
+    void push(const uint8_t* data, size_t size, const SegmentCallback& onSegment);
+    void flush(const SegmentCallback& onSegment);
+
+    static float findPeakAbs(const int16_t* samples, size_t count);
+    static void applyGain(int16_t* samples, size_t count, float gain);
+    static float normalizePeak(int16_t* samples, size_t count);
+
+private:
+    static constexpr float VAD_ENERGY_THRESHOLD = 0.008f;
+    static constexpr float VAD_SPEECH_BAND_RATIO = 0.25f; // share of full-band energy in 300-3400Hz
+
+    static constexpr int VAD_MIN_SPEECH_FRAMES = 12;  // ~240ms
+    static constexpr int VAD_MIN_SILENCE_FRAMES = 18; // ~360ms
+    static constexpr int HANGOVER_MAX = 10; // ~200ms
+    static constexpr size_t VAD_MAX_PENDING_FRAMES = 5; // ~100ms, only reached if the mel frontend stalls
+
+    int channels = 1;
+    size_t frameBytes = 0;
+    size_t frameSamples = 0;
+
+    std::vector<uint8_t> vadBuffer;
+    std::vector<uint8_t> leftoverBytes;
+    int silenceFrames = 0;
+    int speechFrames = 0;
+    int hangoverFrames = 0;
+    bool inSpeech = false;
+
+    size_t vadFrameIndex = 0;
+    size_t segmentStartVadFrame = 0;
+
+    MelFrontend mel;
+
+    void classifyFrames(bool flushing, const SegmentCallback& onSegment);
+    void classifyFrame(const uint8_t* frame, const SegmentCallback& onSegment);
+    void emitSegment(size_t endVadFrame, const SegmentCallback& onSegment);
+    static float frameRMS(const int16_t* samples, size_t count);
+};
@@ -34,17 +34,32 @@ async function initializeKuroshiro() {
   }
 }
 
+const CONFIRMED_SUFFIX = "_CONFIRMED.txt";
+
 function watchTranscripts() {
   const TRANSCRIPT_DIR = "C:\\live-furigana\\Cache\\Transcripts";
   if (watcher) return;
 
   watcher = fs.watch(TRANSCRIPT_DIR, (eventType, filename) => {
-    if (filename && filename.endsWith(".txt")) {
+    if (filename && filename.endsWith(CONFIRMED_SUFFIX)) {
+      const filePath = path.join(TRANSCRIPT_DIR, filename);
+      if (!processedFiles.has(filePath)) {
+        try {
+          const stem = filename.slice(0, -CONFIRMED_SUFFIX.length);
+          const content = fs.readFileSync(filePath, "utf8");
+          mainWindow?.webContents.send("replace-transcript", stem, content.trim());
+          processedFiles.add(filePath);
+        } catch (err) {
+          if (err.code !== "ENOENT") processedFiles.delete(filePath);
+        }
+      }
+    } else if (filename && filename.endsWith(".txt")) {
       const filePath = path.join(TRANSCRIPT_DIR, filename);
       if (!processedFiles.has(filePath)) {
         try {
+          const stem = filename.slice(0, -".txt".length);
           const content = fs.readFileSync(filePath, "utf8");
-          mainWindow?.webContents.send("new-transcript", content.trim());
+          mainWindow?.webContents.send("new-transcript", stem, content.trim());
           processedFiles.add(filePath);
         } catch (err) {
           if (err.code !== "ENOENT") processedFiles.delete(filePath);
@@ -8,10 +8,15 @@ contextBridge.exposeInMainWorld("audioControl", {
 
 contextBridge.exposeInMainWorld("fileSystem", {
   watchTranscripts: (callback) => {
-    const handleTranscript = (_, text) => callback(text);
+    const handleTranscript = (_, stem, text) => callback(text, stem);
     ipcRenderer.on("new-transcript", handleTranscript);
     return () => ipcRenderer.removeListener("new-transcript", handleTranscript);
   },
+  watchTranscriptReplacements: (callback) => {
+    const handleReplacement = (_, stem, text) => callback(stem, text);
+    ipcRenderer.on("replace-transcript", handleReplacement);
+    return () => ipcRenderer.removeListener("replace-transcript", handleReplacement);
+  },
   onBackendReady: (callback) => {
     const handleReady = () => callback();
     ipcRenderer.on("backend-ready", handleReady);
@@ -6,7 +6,8 @@ import "./subtitles.css";
 declare global {
   interface Window {
     fileSystem: {
-      watchTranscripts: (callback: (text: string) => void) => () => void;
+      watchTranscripts: (callback: (text: string, stem: string) => void) => () => void;
+      watchTranscriptReplacements: (callback: (stem: string, text: string) => void) => () => void;
       onBackendReady: (callback: () => void) => () => void;
     };
     kuroshiro: {
@@ -29,6 +30,9 @@ const Subtitles: React.FC<SubtitlesProps> = ({
   setBackendReady,
 }) => {
   const [furiganaSubtitles, setFuriganaSubtitles] = React.useState<string[]>([]);
+  // Segment each line came from, so a confirmed transcript replaces exactly its own draft
+  const lines = React.useRef(subtitles.map((text) => ({ stem: "", text })));
+  const shownStems = React.useRef(new Set<string>());
 
   React.useEffect(() => {
     const cleanup = window.fileSystem.onBackendReady(() => {
@@ -41,23 +45,58 @@ const Subtitles: React.FC<SubtitlesProps> = ({
     if (!backendReady) return;
 
     let lastSubtitle = "";
-    const handleNewTranscript = (text: string) => {
+    const showLines = (next: { stem: string; text: string }[]) => {
+      lines.current = next.slice(-MAX_LINES);
+      setSubtitles(lines.current.map((line) => line.text));
+    };
+
+    const handleNewTranscript = (text: string, stem: string) => {
       if (text && text !== lastSubtitle) {
-        setSubtitles((prev) => {
-          const newArr = [...prev, text];
-          return newArr.slice(-MAX_LINES);
-        });
+        showLines([...lines.current, { stem, text }]);
+        shownStems.current.add(stem);
+        lastSubtitle = text;
+      }
+    };
+
+    // Cascade mode: the confirm model's text replaces its own segment's draft in place, or is appended
+    // if that segment never made it on screen. An empty confirm drops the draft instead.
+    // Drafts that already scrolled away stay gone.
+    const handleReplacement = (stem: string, text: string) => {
+      const index = lines.current.findIndex((line) => line.stem === stem);
+      if (!text) {
+        shownStems.current.add(stem);
+        if (index < 0) return;
+        const next = lines.current.filter((_, i) => i !== index);
+        showLines(next);
+        lastSubtitle = next.length > 0 ? next[next.length - 1].text : "";
+        return;
+      }
+      if (index >= 0) {
+        const next = [...lines.current];
+        next[index] = { stem, text };
+        showLines(next);
+        if (index === next.length - 1) lastSubtitle = text;
+      } else if (!shownStems.current.has(stem)) {
+        showLines([...lines.current, { stem, text }]);
+        shownStems.current.add(stem);
         lastSubtitle = text;
       }
     };
 
     const cleanup = window.fileSystem.watchTranscripts(handleNewTranscript);
-    return cleanup;
+    const cleanupReplacements = window.fileSystem.watchTranscriptReplacements(handleReplacement);
+    return () => {
+      cleanup();
+      cleanupReplacements();
+    };
   }, [backendReady, setSubtitles]);
 
   React.useEffect(() => {
     const processFurigana = async () => {
-      if (subtitles.length === 0) return;
+      if (subtitles.length === 0) {
+        setFuriganaSubtitles([]);
+        return;
+      }
 
       const processed = await Promise.all(
         subtitles.map((text) =>